@@ -2,9 +2,10 @@
 #include "AI/BehaviorTree/BTService_SelectGameplayAbility.h"
 
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
 #include "Abilities/GameplayAbility.h"
+#include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "NinjaGASFunctionLibrary.h"
 
 UBTService_SelectGameplayAbility::UBTService_SelectGameplayAbility(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -62,13 +63,17 @@ void UBTService_SelectGameplayAbility::OnBecomeRelevant(UBehaviorTreeComponent&
 
 bool UBTService_SelectGameplayAbility::CanBeActivated(const UBehaviorTreeComponent& OwnerComp, const TSubclassOf<UGameplayAbility>& AbilityClass)
 {
-	const UAbilitySystemComponent* AbilityComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(OwnerComp.GetOwner());
+	const UAbilitySystemComponent* AbilityComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(OwnerComp.GetOwner());
 	if (!IsValid(AbilityComponent))
 	{
 		return false;
 	}
 
-	const FGameplayAbilitySpec* Spec = AbilityComponent->FindAbilitySpecFromClass(AbilityClass);
+	const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilityComponent);
+	const FGameplayAbilitySpec* Spec = IsValid(NinjaAbilityComponent)
+		? NinjaAbilityComponent->FindAbilitySpecByClass(AbilityClass)
+		: AbilityComponent->FindAbilitySpecFromClass(AbilityClass);
+	
 	if (!Spec)
 	{
 		return false;
@@ -2,10 +2,10 @@
 #include "AI/BehaviorTree/BTService_UpdateAttributes.h"
 
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
 #include "AIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "NinjaGASFunctionLibrary.h"
 
 UBTService_UpdateAttributes::UBTService_UpdateAttributes()
 {
@@ -70,7 +70,7 @@ void UBTService_UpdateAttributes::OnCeaseRelevant(UBehaviorTreeComponent& OwnerC
 	check(MyMemory);
 	
 	const APawn* Pawn = OwnerComp.GetAIOwner()->GetPawn();
-	UAbilitySystemComponent* AbilitySystemComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Pawn);
+	UAbilitySystemComponent* AbilitySystemComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(Pawn);
 
 	if (IsValid(AbilitySystemComponent))
 	{
@@ -118,7 +118,7 @@ void UBTService_UpdateAttributes::BindToAttributes(UBehaviorTreeComponent& Owner
 	if (IsValid(Blackboard))
 	{
 		const APawn* Pawn = OwnerComp.GetAIOwner()->GetPawn();
-		UAbilitySystemComponent* AbilitySystemComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Pawn);
+		UAbilitySystemComponent* AbilitySystemComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(Pawn);
 
 		if (IsValid(AbilitySystemComponent))
 		{
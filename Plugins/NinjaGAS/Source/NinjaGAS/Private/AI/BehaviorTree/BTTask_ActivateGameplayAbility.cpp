@@ -2,11 +2,11 @@
 #include "AI/BehaviorTree/BTTask_ActivateGameplayAbility.h"
 
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
 #include "AIController.h"
 #include "Abilities/GameplayAbility.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "NinjaGASFunctionLibrary.h"
 
 UBTTask_ActivateGameplayAbility::UBTTask_ActivateGameplayAbility()
 {
@@ -57,7 +57,7 @@ EBTNodeResult::Type UBTTask_ActivateGameplayAbility::ExecuteTask(UBehaviorTreeCo
     {
         bool bActivated = false;
         
-        UAbilitySystemComponent* AbilityComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(BotController->GetPawn());
+        UAbilitySystemComponent* AbilityComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(BotController->GetPawn());
         if (IsValid(AbilityComponent))
         {
             switch(ActivationMode)
@@ -142,7 +142,7 @@ void UBTTask_ActivateGameplayAbility::OnTaskFinished(UBehaviorTreeComponent& Own
         const AAIController* BotController = OwnerComp.GetAIOwner();
         if (IsValid(BotController))
         {
-            UAbilitySystemComponent* AbilityComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(BotController->GetPawn());
+            UAbilitySystemComponent* AbilityComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(BotController->GetPawn());
             if (IsValid(AbilityComponent))
             {
                 AbilityComponent->OnAbilityEnded.Remove(MyMemory->AbilityCallbackDelegateHandle);
@@ -2,11 +2,12 @@
 #include "AI/BehaviorTree/BTTask_CancelGameplayAbility.h"
 
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
 #include "AIController.h"
 #include "Abilities/GameplayAbility.h"
+#include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Class.h"
+#include "NinjaGASFunctionLibrary.h"
 
 UBTTask_CancelGameplayAbility::UBTTask_CancelGameplayAbility()
 {
@@ -43,7 +44,7 @@ EBTNodeResult::Type UBTTask_CancelGameplayAbility::ExecuteTask(UBehaviorTreeComp
     {
         bool bCancelled = false;
         
-        UAbilitySystemComponent* AbilityComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(BotController->GetPawn());
+        UAbilitySystemComponent* AbilityComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(BotController->GetPawn());
         if (IsValid(AbilityComponent))
         {
             switch(CancellationMode)
@@ -55,7 +56,11 @@ EBTNodeResult::Type UBTTask_CancelGameplayAbility::ExecuteTask(UBehaviorTreeComp
                 }
             case EAgentAbilityActivationMode::AbilityClass:
                 {
-                    const FGameplayAbilitySpec* Spec = AbilityComponent->FindAbilitySpecFromClass(AbilityClass);
+                    const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilityComponent);
+                    const FGameplayAbilitySpec* Spec = IsValid(NinjaAbilityComponent)
+                        ? NinjaAbilityComponent->FindAbilitySpecByClass(AbilityClass)
+                        : AbilityComponent->FindAbilitySpecFromClass(AbilityClass);
+                    
                     if (Spec != nullptr && Spec->Handle.IsValid())
                     {
                         AbilityComponent->CancelAbilityHandle(Spec->Handle);
@@ -3,251 +3,1959 @@
 
 #include "AbilitySystemGlobals.h"
 #include "GameplayCueManager.h"
+#include "NinjaGASFunctionLibrary.h"
 #include "NinjaGASLog.h"
+#include "NinjaGASStats.h"
+#include "NinjaGASSubsystem.h"
+#include "NinjaGASWorldSubsystem.h"
 #include "Animation/AnimInstance.h"
 #include "Animation/AnimMontage.h"
+#include "Algo/Count.h"
+#include "AbilitySystem/NinjaGASGameplayAbility.h"
+#include "AbilitySystem/Types/FNinjaMontageSectionCache.h"
 #include "Data/NinjaGASDataAsset.h"
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/Pawn.h"
 #include "Interfaces/AbilitySystemDefaultsInterface.h"
 #include "Interfaces/BatchGameplayAbilityInterface.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Montage Net Updates Requested"), STAT_NinjaGAS_MontageNetUpdatesRequested, STATGROUP_NinjaGAS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Montage Net Updates Forced"), STAT_NinjaGAS_MontageNetUpdatesForced, STATGROUP_NinjaGAS);
+DECLARE_CYCLE_STAT(TEXT("Effect Batch Application"), STAT_NinjaGAS_EffectBatchApplication, STATGROUP_NinjaGAS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effect Batch Targets"), STAT_NinjaGAS_EffectBatchTargets, STATGROUP_NinjaGAS);
+
+/**
+ * CVAR to control if forced net updates from "Play Montage" are coalesced.
+ * Example: ninjagas.MontageNetUpdate.Coalesce false
+ */
+static bool GCoalesceMontageNetUpdates = true;
+static FAutoConsoleVariableRef CVarCoalesceMontageNetUpdates(
+	TEXT("ninjagas.MontageNetUpdate.Coalesce"),
+	GCoalesceMontageNetUpdates,
+	TEXT("Defers forced net updates from montages to the end of the frame, sending at most one per avatar."),
+	ECVF_Default
+);
+
+/**
+ * CVAR to control the minimum interval between coalesced forced net updates from "Play Montage".
+ * Example: ninjagas.MontageNetUpdate.MinInterval 0.05
+ */
+static float GMontageNetUpdateMinInterval = 0.f;
+static FAutoConsoleVariableRef CVarMontageNetUpdateMinInterval(
+	TEXT("ninjagas.MontageNetUpdate.MinInterval"),
+	GMontageNetUpdateMinInterval,
+	TEXT("Minimum seconds between forced net updates from montages, for the same avatar. Zero allows one per frame."),
+	ECVF_Default
+);
+
+/**
+ * CVAR to control the size of replicated gameplay cue batches.
+ * Example: ninjagas.CueBatch.MaxEntries 64
+ */
+static int32 GGameplayCueBatchMaxEntries = 32;
+static FAutoConsoleVariableRef CVarGameplayCueBatchMaxEntries(
+	TEXT("ninjagas.CueBatch.MaxEntries"),
+	GGameplayCueBatchMaxEntries,
+	TEXT("Maximum cues in a single replicated gameplay cue batch. Full batches are sent right away."),
+	ECVF_Default
+);
+
+namespace NinjaGASDefaults
+{
+	/**
+	 * Matches new default entries against the ones currently tracked.
+	 *
+	 * @param TrackedEntries	Entries currently granted.
+	 * @param NewEntries		Entries from the new setup.
+	 * @param CanKeep			Checks if a tracked entry, by index, is still granted and can be kept.
+	 * @param OutKeep			Flags for each tracked entry, set if the entry is also in the new setup.
+	 * @param OutToAdd			New entries that are not currently granted.
+	 */
+	template<typename TEntry, typename TCanKeep>
+	void DiffEntries(const TArray<TEntry>& TrackedEntries, const TArray<TEntry>& NewEntries, const TCanKeep& CanKeep, TBitArray<>& OutKeep, TArray<TEntry>& OutToAdd)
+	{
+		OutKeep.Init(false, TrackedEntries.Num());
+		for (const TEntry& Entry : NewEntries)
+		{
+			int32 MatchIndex = INDEX_NONE;
+			for (int32 Index = 0; Index < TrackedEntries.Num(); ++Index)
+			{
+				if (!OutKeep[Index] && TrackedEntries[Index] == Entry && CanKeep(Index))
+				{
+					MatchIndex = Index;
+					break;
+				}
+			}
+
+			if (MatchIndex != INDEX_NONE)
+			{
+				OutKeep[MatchIndex] = true;
+			}
+			else
+			{
+				OutToAdd.Add(Entry);
+			}
+		}
+	}
+
+	/**
+	 * How an instant default effect relates to the attribute sets being removed or re-created.
+	 */
+	enum class EInstantEffectTargets : uint8
+	{
+		NotInstant,
+		Kept,
+		Recreated,
+		Mixed
+	};
+
+	/**
+	 * Classifies an instant default effect by the attribute sets it modifies.
+	 *
+	 * Executions may modify any attribute, so their targets are only known when no set is touched.
+	 *
+	 * @param Entry				Default effect to classify.
+	 * @param TouchedSets		Attribute set classes being removed or re-created.
+	 */
+	EInstantEffectTargets ClassifyInstantEffect(const FDefaultGameplayEffect& Entry, const TSet<const UClass*>& TouchedSets)
+	{
+		const TSubclassOf<UGameplayEffect> EffectClass = Entry.GameplayEffectClass.LoadSynchronous();
+		const UGameplayEffect* Effect = IsValid(EffectClass) ? GetDefault<UGameplayEffect>(EffectClass) : nullptr;
+		if (!IsValid(Effect) || Effect->DurationPolicy != EGameplayEffectDurationType::Instant)
+		{
+			return EInstantEffectTargets::NotInstant;
+		}
+
+		if (TouchedSets.IsEmpty())
+		{
+			return EInstantEffectTargets::Kept;
+		}
+
+		if (!Effect->Executions.IsEmpty())
+		{
+			return EInstantEffectTargets::Mixed;
+		}
+
+		bool bModifiesKeptSet = false;
+		bool bModifiesTouchedSet = false;
+		for (const FGameplayModifierInfo& Modifier : Effect->Modifiers)
+		{
+			const UClass* AttributeSetClass = Modifier.Attribute.GetAttributeSetClass();
+			if (TouchedSets.Contains(AttributeSetClass))
+			{
+				bModifiesTouchedSet = true;
+			}
+			else
+			{
+				bModifiesKeptSet = true;
+			}
+		}
+
+		if (bModifiesKeptSet && bModifiesTouchedSet)
+		{
+			return EInstantEffectTargets::Mixed;
+		}
+
+		return bModifiesTouchedSet ? EInstantEffectTargets::Recreated : EInstantEffectTargets::Kept;
+	}
+}
 
 UNinjaGASAbilitySystemComponent::UNinjaGASAbilitySystemComponent()
 {
-	static constexpr bool bIsReplicated = true;
-	SetIsReplicatedByDefault(bIsReplicated);
+	static constexpr bool bIsReplicated = true;
+	SetIsReplicatedByDefault(bIsReplicated);
+
+	bEnableAbilityBatchRPC = true;
+	bCollectingAbilityRPCBatches = false;
+	bIncrementalDefaultsUpdate = true;
+	bUseCompiledAttributeInitializers = false;
+	bAsyncLoadDefaults = false;
+	bUseCentralizedTick = false;
+	bQueueLocalGameplayCues = false;
+	bBatchReplicatedGameplayCues = false;
+	bGameplayCueBatchQueued = false;
+	bMontageNetUpdatePending = false;
+	LastMontageNetUpdateTime = -UE_BIG_NUMBER;
+	bCentrallyTicked = false;
+	bEnableHibernation = false;
+	HibernationDistance = 0.f;
+	WakeDistance = 0.f;
+	HibernationNetUpdateFrequency = 1.f;
+	bHibernating = false;
+	HibernationStartTime = 0.0;
+	PreHibernationNetUpdateFrequency = 0.f;
+	PreHibernationMinNetUpdateFrequency = 0.f;
+	CurrentAbilitySetup = nullptr;
+	PendingAbilitySetup = nullptr;
+	bAbilitySpecIndicesDirty = true;
+}
+
+void UNinjaGASAbilitySystemComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bUseCentralizedTick)
+	{
+		if (UNinjaGASWorldSubsystem* WorldSubsystem = GetNinjaGASWorldSubsystem())
+		{
+			WorldSubsystem->RegisterAbilitySystem(this);
+			bCentrallyTicked = true;
+			SetComponentTickEnabled(false);
+		}
+	}
+
+	if (bEnableHibernation)
+	{
+		if (UNinjaGASWorldSubsystem* WorldSubsystem = GetNinjaGASWorldSubsystem())
+		{
+			WorldSubsystem->RegisterHibernationCandidate(this);
+		}
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Cues and ability RPCs batched in this frame are sent while the owner is still replicating.
+	SendGameplayCueBatch();
+	FlushFrameAbilityRPCBatch();
+
+	if (UNinjaGASSubsystem* Subsystem = GetNinjaGASSubsystem())
+	{
+		Subsystem->UnregisterAbilitySystemComponent(this);
+	}
+	
+	if (bCentrallyTicked)
+	{
+		if (UNinjaGASWorldSubsystem* WorldSubsystem = GetNinjaGASWorldSubsystem())
+		{
+			WorldSubsystem->UnregisterAbilitySystem(this);
+		}
+
+		bCentrallyTicked = false;
+	}
+
+	if (bEnableHibernation)
+	{
+		if (UNinjaGASWorldSubsystem* WorldSubsystem = GetNinjaGASWorldSubsystem())
+		{
+			WorldSubsystem->UnregisterHibernationCandidate(this);
+		}
+
+		// Effects are going away with the component, so there is nothing to catch up.
+		HibernatedPeriodicEffects.Reset();
+		bHibernating = false;
+	}
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UNinjaGASAbilitySystemComponent::GetShouldTick() const
+{
+	// Centrally ticked and hibernating components keep their own tick disabled, even when tasks are added.
+	return !bCentrallyTicked && !bHibernating && Super::GetShouldTick();
+}
+
+void UNinjaGASAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor)
+{
+	// Guard condition to ensure we should clear/init for this new Avatar Actor.
+	const bool bAvatarHasChanged = AbilityActorInfo && AbilityActorInfo->AvatarActor != InAvatarActor && InAvatarActor != nullptr;
+	
+	Super::InitAbilityActorInfo(InOwnerActor, InAvatarActor);
+
+	if (UNinjaGASSubsystem* Subsystem = GetNinjaGASSubsystem())
+	{
+		Subsystem->RegisterAbilitySystemComponent(this, InOwnerActor, InAvatarActor);
+	}
+
+	// Apply the new defaults obtained from the owner's interface.
+	if (bAvatarHasChanged)
+	{
+		InitializeDefaults(InAvatarActor);
+
+		// Cue notify pools are cosmetic, so they are prewarmed wherever cues play, not only on the authority.
+		if (UNinjaGASWorldSubsystem* WorldSubsystem = GetNinjaGASWorldSubsystem())
+		{
+			WorldSubsystem->PrewarmCueNotifyPools(ResolveAbilityData(InAvatarActor));
+		}
+		
+		OnAbilitySystemAvatarChanged.Broadcast(InAvatarActor);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::InitializeDefaults(const AActor* NewAvatarActor)
+{
+	if (!IsValid(NewAvatarActor) || !IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	const UNinjaGASDataAsset* AbilityData = ResolveAbilityData(NewAvatarActor);
+	if (!IsValid(AbilityData) || AbilityData == CurrentAbilitySetup || AbilityData == PendingAbilitySetup)
+	{
+		return;
+	}
+
+	if (bAsyncLoadDefaults && !AbilityData->IsAbilityBundleLoaded())
+	{
+		LoadAbilityData(NewAvatarActor, AbilityData);
+	}
+	else
+	{
+		PendingAbilitySetup = nullptr;
+		ApplyAbilityData(NewAvatarActor, AbilityData);
+	}
+}
+
+const UNinjaGASDataAsset* UNinjaGASAbilitySystemComponent::ResolveAbilityData(const AActor* NewAvatarActor) const
+{
+	const IAbilitySystemDefaultsInterface* Defaults = Cast<IAbilitySystemDefaultsInterface>(NewAvatarActor);
+	if (Defaults == nullptr || !Defaults->HasAbilityData())
+	{
+		// Use the defaults provided by this own class.
+		Defaults = Cast<IAbilitySystemDefaultsInterface>(this);
+	}
+
+	return Defaults->GetAbilityData();
+}
+
+void UNinjaGASAbilitySystemComponent::LoadAbilityData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData)
+{
+	PendingAbilitySetup = AbilityData;
+	
+	const TWeakObjectPtr<const AActor> WeakAvatar = NewAvatarActor;
+	const TWeakObjectPtr<const UNinjaGASDataAsset> WeakAbilityData = AbilityData;
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateWeakLambda(this, [this, WeakAvatar, WeakAbilityData]()
+	{
+		HandleAbilityDataLoaded(WeakAvatar.Get(), WeakAbilityData.Get());
+	});
+
+	const TSharedPtr<FStreamableHandle> LoadHandle = AbilityData->LoadAbilityBundle(OnLoaded);
+	if (PendingAbilitySetup != AbilityData)
+	{
+		// Already completed, while the request was being made.
+		AbilityDataHandle = LoadHandle;
+		return;
+	}
+
+	PendingAbilityDataHandle = LoadHandle;
+	if (!LoadHandle.IsValid() || LoadHandle->HasLoadCompleted())
+	{
+		// The request could not be made, or there was nothing to wait for. Initialize right away.
+		HandleAbilityDataLoaded(NewAvatarActor, AbilityData);
+		return;
+	}
+
+	UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Loading ability bundle from %s."), *GetNameSafe(GetAvatarActor()), *GetNameSafe(AbilityData));
+}
+
+void UNinjaGASAbilitySystemComponent::HandleAbilityDataLoaded(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData)
+{
+	if (!IsValid(AbilityData) || AbilityData != PendingAbilitySetup)
+	{
+		// Cancelled or replaced by another setup while loading.
+		return;
+	}
+
+	PendingAbilitySetup = nullptr;
+	AbilityDataHandle = MoveTemp(PendingAbilityDataHandle);
+	
+	if (IsValid(NewAvatarActor) && NewAvatarActor == GetAvatarActor())
+	{
+		ApplyAbilityData(NewAvatarActor, AbilityData);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::ApplyAbilityData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData)
+{
+	if (bIncrementalDefaultsUpdate && IsValid(CurrentAbilitySetup))
+	{
+		UpdateFromData(NewAvatarActor, AbilityData);
+	}
+	else
+	{
+		ClearDefaults();
+		CurrentAbilitySetup = AbilityData;
+		InitializeFromData(NewAvatarActor, AbilityData);
+	}
+
+	if (CurrentAbilitySetup == AbilityData)
+	{
+		OnAbilitySystemDefaultsInitialized.Broadcast(AbilityData);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::InitializeFromData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData)
+{
+	if (!IsValid(AbilityData) || !IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	const AActor* CurrentAvatar = GetAvatarActor();
+	if (NewAvatarActor != CurrentAvatar)
+	{
+		return;
+	}
+	
+	const TArray<FDefaultAttributeSet>& AttributeSets = AbilityData->DefaultAttributeSets;
+	InitializeAttributeSets(AttributeSets);
+
+	const TArray<FDefaultGameplayEffect>& GameplayEffects = AbilityData->DefaultGameplayEffects;
+	InitializeGameplayEffects(GameplayEffects);
+
+	const TArray<FDefaultGameplayAbility>& GameplayAbilities = AbilityData->DefaultGameplayAbilities;
+	InitializeGameplayAbilities(GameplayAbilities);
+
+	const FGameplayTagContainer& InitialGameplayTags = AbilityData->InitialGameplayTags; 
+	if (InitialGameplayTags.IsValid())
+	{
+		AddReplicatedLooseGameplayTags(InitialGameplayTags);
+	}
+	
+	UE_LOG(LogAbilitySystemComponent, Log, TEXT("Initialized ASC defaults from %s: [ Attribute Sets: %d, Effects: %d, Abilities: %d, Tags %d ]."),
+		*GetNameSafe(AbilityData), AddedAttributes.Num(), DefaultEffectHandles.Num(), DefaultAbilityHandles.Num(), InitialGameplayTags.Num());	
+}
+
+void UNinjaGASAbilitySystemComponent::UpdateFromData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData)
+{
+	if (!IsValid(AbilityData) || !IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	const AActor* CurrentAvatar = GetAvatarActor();
+	if (NewAvatarActor != CurrentAvatar)
+	{
+		return;
+	}
+
+	const FGameplayTagContainer PreviousGameplayTags = IsValid(CurrentAbilitySetup) ? CurrentAbilitySetup->InitialGameplayTags : FGameplayTagContainer::EmptyContainer;
+	
+	TBitArray<> KeepAbilities;
+	TArray<FDefaultGameplayAbility> AbilitiesToAdd;
+	NinjaGASDefaults::DiffEntries(DefaultAbilityEntries, AbilityData->DefaultGameplayAbilities,
+		[this](const int32 Index) { return FindAbilitySpecByHandle(DefaultAbilityHandles[Index]) != nullptr; },
+		KeepAbilities, AbilitiesToAdd);
+
+	TBitArray<> KeepAttributeSets;
+	TArray<FDefaultAttributeSet> AttributeSetsToAdd;
+	NinjaGASDefaults::DiffEntries(AddedAttributeEntries, AbilityData->DefaultAttributeSets,
+		[this](const int32 Index) { return IsValid(AddedAttributes[Index]); },
+		KeepAttributeSets, AttributeSetsToAdd);
+
+	TSet<const UClass*> TouchedAttributeSets;
+	for (int32 Index = 0; Index < AddedAttributes.Num(); ++Index)
+	{
+		if (!KeepAttributeSets[Index] && IsValid(AddedAttributes[Index]))
+		{
+			TouchedAttributeSets.Add(AddedAttributes[Index]->GetClass());
+		}
+	}
+
+	// Instant effects have no active handle. They are kept while all their attribute sets are kept.
+	TBitArray<> KeepEffects;
+	TArray<FDefaultGameplayEffect> EffectsToAdd;
+	NinjaGASDefaults::DiffEntries(DefaultEffectEntries, AbilityData->DefaultGameplayEffects,
+		[this, &TouchedAttributeSets](const int32 Index)
+		{
+			return GetActiveGameplayEffect(DefaultEffectHandles[Index]) != nullptr
+				|| NinjaGASDefaults::ClassifyInstantEffect(DefaultEffectEntries[Index], TouchedAttributeSets) == NinjaGASDefaults::EInstantEffectTargets::Kept;
+		},
+		KeepEffects, EffectsToAdd);
+
+	// Instant effects not kept cannot be undone, so they must only have modified sets being re-created.
+	for (int32 Index = 0; Index < DefaultEffectEntries.Num(); ++Index)
+	{
+		if (!KeepEffects[Index])
+		{
+			const NinjaGASDefaults::EInstantEffectTargets Targets = NinjaGASDefaults::ClassifyInstantEffect(DefaultEffectEntries[Index], TouchedAttributeSets);
+			if (Targets == NinjaGASDefaults::EInstantEffectTargets::Kept || Targets == NinjaGASDefaults::EInstantEffectTargets::Mixed)
+			{
+				UE_LOG(LogAbilitySystemComponent, Log, TEXT("[%s] Instant effect %s cannot be reconciled with %s, granting all defaults again."),
+					*GetNameSafe(GetAvatarActor()), *DefaultEffectEntries[Index].GameplayEffectClass.ToString(), *GetNameSafe(AbilityData));
+
+				ClearDefaults();
+				CurrentAbilitySetup = AbilityData;
+				InitializeFromData(NewAvatarActor, AbilityData);
+				return;
+			}
+		}
+	}
+
+	// Remove whatever is not part of the new setup, from dependents to dependencies.
+	int32 RemovedCount = 0;
+	for (int32 Index = DefaultAbilityHandles.Num() - 1; Index >= 0; --Index)
+	{
+		if (!KeepAbilities[Index])
+		{
+			SetRemoveAbilityOnEnd(DefaultAbilityHandles[Index]);
+			DefaultAbilityHandles.RemoveAt(Index);
+			DefaultAbilityEntries.RemoveAt(Index);
+			++RemovedCount;
+		}
+	}
+
+	for (int32 Index = DefaultEffectHandles.Num() - 1; Index >= 0; --Index)
+	{
+		if (!KeepEffects[Index])
+		{
+			RemoveActiveGameplayEffect(DefaultEffectHandles[Index]);
+			DefaultEffectHandles.RemoveAt(Index);
+			DefaultEffectEntries.RemoveAt(Index);
+			++RemovedCount;
+		}
+	}
+
+	for (int32 Index = AddedAttributes.Num() - 1; Index >= 0; --Index)
+	{
+		if (!KeepAttributeSets[Index])
+		{
+			RemoveSpawnedAttribute(AddedAttributes[Index]);
+			AddedAttributes.RemoveAt(Index);
+			AddedAttributeEntries.RemoveAt(Index);
+			++RemovedCount;
+		}
+	}
+
+	FGameplayTagContainer TagsToRemove;
+	for (const FGameplayTag& Tag : PreviousGameplayTags)
+	{
+		if (!AbilityData->InitialGameplayTags.HasTagExact(Tag))
+		{
+			TagsToRemove.AddTag(Tag);
+		}
+	}
+	
+	if (TagsToRemove.IsValid())
+	{
+		RemoveReplicatedLooseGameplayTags(TagsToRemove);
+		RemovedCount += TagsToRemove.Num();
+	}
+
+	// Grant whatever is new, from dependencies to dependents.
+	CurrentAbilitySetup = AbilityData;
+	InitializeAttributeSets(AttributeSetsToAdd);
+	InitializeGameplayEffects(EffectsToAdd);
+	InitializeGameplayAbilities(AbilitiesToAdd);
+
+	FGameplayTagContainer TagsToAdd;
+	for (const FGameplayTag& Tag : AbilityData->InitialGameplayTags)
+	{
+		if (!PreviousGameplayTags.HasTagExact(Tag))
+		{
+			TagsToAdd.AddTag(Tag);
+		}
+	}
+	
+	if (TagsToAdd.IsValid())
+	{
+		AddReplicatedLooseGameplayTags(TagsToAdd);
+	}
+
+	const int32 AddedCount = AttributeSetsToAdd.Num() + EffectsToAdd.Num() + AbilitiesToAdd.Num() + TagsToAdd.Num();
+	const int32 TotalCount = AddedAttributes.Num() + DefaultEffectHandles.Num() + DefaultAbilityHandles.Num() + AbilityData->InitialGameplayTags.Num();
+	
+	UE_LOG(LogAbilitySystemComponent, Log, TEXT("[%s] Updated ASC defaults to %s: [ Kept: %d, Added: %d, Removed: %d ]."),
+		*GetNameSafe(GetAvatarActor()), *GetNameSafe(AbilityData), TotalCount - AddedCount, AddedCount, RemovedCount);
+}
+
+void UNinjaGASAbilitySystemComponent::InitializeAttributeSets(const TArray<FDefaultAttributeSet>& AttributeSets)
+{
+	for (const FDefaultAttributeSet& Entry : AttributeSets)
+	{
+		// Already resolved when the ability bundle was loaded. Otherwise, this will load them now.
+		const TSubclassOf<UAttributeSet> AttributeSetClass = Entry.AttributeSetClass.LoadSynchronous();
+		const UDataTable* AttributeTable = Entry.AttributeTable.LoadSynchronous();
+		if (!IsValid(AttributeSetClass))
+		{
+			continue;
+		}
+		
+		UAttributeSet* NewAttributeSet = NewObject<UAttributeSet>(GetOwner(), AttributeSetClass);
+		if (GetSpawnedAttributes().Contains(NewAttributeSet))
+		{
+			UE_LOG(LogAbilitySystemComponent, Warning, TEXT("Discarding Attribute Set %s since it was already spawned."), *GetNameSafe(NewAttributeSet));
+		}
+		else
+		{
+			if (IsValid(AttributeTable))
+			{
+				// Compiled initializers skip the virtual table initialization, so they must be enabled explicitly.
+				UNinjaGASSubsystem* Subsystem = bUseCompiledAttributeInitializers ? GetNinjaGASSubsystem() : nullptr;
+				if (IsValid(Subsystem))
+				{
+					Subsystem->GetAttributeInitializer(AttributeSetClass, AttributeTable)->Apply(NewAttributeSet);
+				}
+				else
+				{
+					NewAttributeSet->InitFromMetaDataTable(AttributeTable);
+				}
+				
+				UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("Initialized Attribute Set %s with %s."), *GetNameSafe(NewAttributeSet), *GetNameSafe(AttributeTable));
+			}
+
+			AddAttributeSetSubobject(NewAttributeSet);
+			AddedAttributes.Add(NewAttributeSet);
+			AddedAttributeEntries.Add(Entry);			
+		}
+	}		
+}
+
+void UNinjaGASAbilitySystemComponent::InitializeGameplayEffects(const TArray<FDefaultGameplayEffect>& GameplayEffects)
+{
+	const int32 GameplayEffectCount = GameplayEffects.Num(); 
+	if (GameplayEffectCount > 0)
+	{
+		const int32 NewSize = DefaultEffectHandles.Num() + GameplayEffectCount;  
+		DefaultEffectHandles.Reserve(NewSize);
+		DefaultEffectEntries.Reserve(NewSize);
+
+		// Gameplay cues are only sent once all effects are applied. Attributes are still updated
+		// per effect, since later effects and attribute set callbacks may read the current values.
+		FScopedGameplayCueSendContext GameplayCueSendContext;
+		
+		for (const FDefaultGameplayEffect& Entry : GameplayEffects)
+		{
+			const TSubclassOf<UGameplayEffect> GameplayEffectClass = Entry.GameplayEffectClass.LoadSynchronous();
+			FActiveGameplayEffectHandle Handle = ApplyGameplayEffectClassToSelf(GameplayEffectClass, Entry.Level);
+			DefaultEffectHandles.Add(Handle);
+			DefaultEffectEntries.Add(Entry);
+		}
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::InitializeGameplayAbilities(const TArray<FDefaultGameplayAbility>& GameplayAbilities)
+{
+	const int32 GameplayAbilityCount = GameplayAbilities.Num(); 
+	if (GameplayAbilityCount > 0)
+	{
+		TArray<FGameplayAbilitySpec> AbilitySpecs;
+		AbilitySpecs.Reserve(GameplayAbilityCount);
+		
+		for (const FDefaultGameplayAbility& Entry : GameplayAbilities)
+		{
+			const TSubclassOf<UGameplayAbility> GameplayAbilityClass = Entry.GameplayAbilityClass.LoadSynchronous();
+			AbilitySpecs.Emplace(GameplayAbilityClass, Entry.Level, Entry.Input, GetOwner());
+		}
+
+		TArray<FGameplayAbilitySpecHandle> Handles;
+		GiveAbilitiesBatch(AbilitySpecs, Handles);
+		
+		DefaultAbilityHandles.Append(Handles);
+		DefaultAbilityEntries.Append(GameplayAbilities);
+	}
+}
+
+FActiveGameplayEffectHandle UNinjaGASAbilitySystemComponent::ApplyGameplayEffectClassToSelf(const TSubclassOf<UGameplayEffect> EffectClass, const float Level)
+{
+	FActiveGameplayEffectHandle Handle;
+    
+	if (IsValid(EffectClass))
+	{
+		FGameplayEffectContextHandle ContextHandle = MakeEffectContext();
+		ContextHandle.AddSourceObject(GetOwner());
+
+		const FGameplayEffectSpecHandle SpecHandle = MakeOutgoingSpec(EffectClass, Level, ContextHandle);
+		if (SpecHandle.IsValid())
+		{
+			Handle = ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
+			
+			UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Effect '%s' granted at level %f."),
+				*GetNameSafe(GetAvatarActor()), *GetNameSafe(EffectClass), Level);
+		}
+	}
+
+	return Handle;	
+}
+
+FNinjaEffectBatchResult UNinjaGASAbilitySystemComponent::ApplyGameplayEffectSpecToTargets(const FGameplayEffectSpec& Spec,
+	const TArray<AActor*>& Targets, TArray<FActiveGameplayEffectHandle>& OutHandles, const FPredictionKey PredictionKey)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NinjaGAS_EffectBatchApplication);
+	
+	FNinjaEffectBatchResult Result;
+	OutHandles.Reset(Targets.Num());
+	OutHandles.SetNum(Targets.Num());
+
+	if (!IsValid(Spec.Def) || Targets.IsEmpty())
+	{
+		return Result;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	
+	TArray<UAbilitySystemComponent*> TargetComponents;
+	UNinjaGASFunctionLibrary::GetAbilitySystemComponentsFromActors(Targets, TargetComponents);
+
+	{
+		// Cues from all targets are gathered and sent once the batch is over.
+		FScopedGameplayCueSendContext GameplayCueSendContext;
+
+		for (int32 Index = 0; Index < TargetComponents.Num(); ++Index)
+		{
+			UAbilitySystemComponent* TargetComponent = TargetComponents[Index];
+			if (!IsValid(TargetComponent))
+			{
+				continue;
+			}
+
+			OutHandles[Index] = ApplyGameplayEffectSpecToTarget(Spec, TargetComponent, PredictionKey);
+			
+			++Result.TargetsProcessed;
+			if (OutHandles[Index].WasSuccessfullyApplied())
+			{
+				++Result.EffectsApplied;
+			}
+		}
+	}
+
+	Result.ElapsedMilliseconds = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+	Result.TargetsPerMillisecond = Result.ElapsedMilliseconds > 0.f ? Result.TargetsProcessed / Result.ElapsedMilliseconds : 0.f;
+	INC_DWORD_STAT_BY(STAT_NinjaGAS_EffectBatchTargets, Result.TargetsProcessed);
+
+	UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Effect '%s' applied to %d of %d targets in %.3f ms (%.1f targets/ms)."),
+		*GetNameSafe(GetAvatarActor()), *GetNameSafe(Spec.Def), Result.EffectsApplied, Targets.Num(),
+		Result.ElapsedMilliseconds, Result.TargetsPerMillisecond);
+	
+	return Result;
+}
+
+FGameplayAbilitySpecHandle UNinjaGASAbilitySystemComponent::GiveAbilityFromClass(const TSubclassOf<UGameplayAbility> AbilityClass, const int32 Level, const int32 Input)
+{
+	FGameplayAbilitySpecHandle Handle;
+
+	if (IsValid(AbilityClass))
+	{
+		const FGameplayAbilitySpec NewAbilitySpec(FGameplayAbilitySpec(AbilityClass, Level, Input, GetOwner()));
+		Handle = GiveAbility(NewAbilitySpec);
+
+		UE_LOG(LogAbilitySystemComponent, Log, TEXT("[%s] Ability '%s' %s at level %d."),
+			*GetNameSafe(GetAvatarActor()), *GetNameSafe(AbilityClass),
+			Handle.IsValid() ? TEXT("successfully granted") : TEXT("failed to be granted"), Level);
+	}
+
+	return Handle;
+}
+
+void UNinjaGASAbilitySystemComponent::GiveAbilitiesBatch(const TArray<FGameplayAbilitySpec>& AbilitySpecs, TArray<FGameplayAbilitySpecHandle>& OutHandles)
+{
+	OutHandles.Reset(AbilitySpecs.Num());
+	
+	if (!IsOwnerActorAuthoritative())
+	{
+		UE_LOG(LogAbilitySystemComponent, Error, TEXT("[%s] GiveAbilitiesBatch called on a non-authoritative ASC."), *GetNameSafe(GetOwner()));
+		OutHandles.SetNum(AbilitySpecs.Num());
+		return;
+	}
+
+	if (AbilityScopeLockCount > 0)
+	{
+		// The ability list is locked, so each spec must wait in the pending list.
+		for (const FGameplayAbilitySpec& AbilitySpec : AbilitySpecs)
+		{
+			OutHandles.Add(IsValid(AbilitySpec.Ability) ? GiveAbility(AbilitySpec) : FGameplayAbilitySpecHandle());
+		}
+		return;
+	}
+
+	ABILITYLIST_SCOPE_LOCK();
+	
+	TArray<FGameplayAbilitySpec>& Items = ActivatableAbilities.Items;
+	const int32 FirstIndex = Items.Num();
+	Items.Reserve(FirstIndex + AbilitySpecs.Num());
+
+	for (const FGameplayAbilitySpec& AbilitySpec : AbilitySpecs)
+	{
+		if (!IsValid(AbilitySpec.Ability))
+		{
+			OutHandles.Add(FGameplayAbilitySpecHandle());
+			continue;
+		}
+
+		const int32 Index = Items.Add(AbilitySpec);
+		if (AbilitySpec.Ability->GetInstancingPolicy() == EGameplayAbilityInstancingPolicy::InstancedPerActor)
+		{
+			CreateNewInstanceOfAbility(Items[Index], AbilitySpec.Ability);
+		}
+
+		OnGiveAbility(Items[Index]);
+		OutHandles.Add(AbilitySpec.Handle);
+	}
+
+	// Single pass over the new items: assigns replication IDs and notifies listeners.
+	for (int32 Index = FirstIndex; Index < Items.Num(); ++Index)
+	{
+		ActivatableAbilities.MarkItemDirty(Items[Index]);
+		AbilitySpecDirtiedCallbacks.Broadcast(Items[Index]);
+	}
+
+	UE_LOG(LogAbilitySystemComponent, Log, TEXT("[%s] Granted %d of %d abilities in batch."),
+		*GetNameSafe(GetAvatarActor()), Items.Num() - FirstIndex, AbilitySpecs.Num());
+}
+
+bool UNinjaGASAbilitySystemComponent::TryBatchActivateAbility(const FGameplayAbilitySpecHandle AbilityHandle, const bool bEndAbilityImmediately)
+{
+	bool bAbilityActivated = false;
+	if (!AbilityHandle.IsValid())
+	{
+		GAS_LOG(Warning, "Ability handle is invalid!");
+		return bAbilityActivated;
+	}
+	
+	FScopedServerAbilityRPCBatcher Batch(this, AbilityHandle);
+	bAbilityActivated = TryActivateAbility(AbilityHandle, true);
+
+	if (bAbilityActivated && bEndAbilityImmediately)
+	{
+		EndAbilityFromBatch(AbilityHandle);
+	}
+
+	return bAbilityActivated;
+}
+
+int32 UNinjaGASAbilitySystemComponent::TryBatchActivateAbilities(const TArray<FGameplayAbilitySpecHandle>& AbilityHandles,
+	const bool bEndAbilitiesImmediately, TArray<bool>& OutActivated)
+{
+	OutActivated.Reset(AbilityHandles.Num());
+	OutActivated.SetNumZeroed(AbilityHandles.Num());
+
+	// Batches are only opened for valid handles without a batch of their own, such as the frame batch.
+	TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>> BatchedHandles;
+	if (ShouldDoServerAbilityRPCBatch())
+	{
+		for (const FGameplayAbilitySpecHandle& AbilityHandle : AbilityHandles)
+		{
+			if (AbilityHandle.IsValid() && !BatchedHandles.Contains(AbilityHandle)
+				&& LocalServerAbilityRPCBatchData.FindByKey(AbilityHandle) == nullptr)
+			{
+				BeginServerAbilityRPCBatch(AbilityHandle);
+				BatchedHandles.Add(AbilityHandle);
+			}
+		}
+	}
+
+	int32 Activations = 0;
+	for (int32 Index = 0; Index < AbilityHandles.Num(); ++Index)
+	{
+		const FGameplayAbilitySpecHandle& AbilityHandle = AbilityHandles[Index];
+		if (!AbilityHandle.IsValid())
+		{
+			GAS_LOG(Warning, "Ability handle is invalid!");
+			continue;
+		}
+
+		OutActivated[Index] = TryActivateAbility(AbilityHandle, true);
+		if (OutActivated[Index])
+		{
+			++Activations;
+			if (bEndAbilitiesImmediately)
+			{
+				EndAbilityFromBatch(AbilityHandle);
+			}
+		}
+	}
+
+	if (!BatchedHandles.IsEmpty())
+	{
+		const bool bWasCollecting = bCollectingAbilityRPCBatches;
+		bCollectingAbilityRPCBatches = true;
+		
+		for (const FGameplayAbilitySpecHandle& AbilityHandle : BatchedHandles)
+		{
+			EndServerAbilityRPCBatch(AbilityHandle);
+		}
+
+		bCollectingAbilityRPCBatches = bWasCollecting;
+		if (!bCollectingAbilityRPCBatches)
+		{
+			SendCollectedAbilityRPCBatches();
+		}
+	}
+
+	return Activations;
+}
+
+void UNinjaGASAbilitySystemComponent::EndAbilityFromBatch(const FGameplayAbilitySpecHandle AbilityHandle) const
+{
+	const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(AbilityHandle);
+	if (AbilitySpec != nullptr)
+	{
+		UGameplayAbility* Ability = AbilitySpec->GetPrimaryInstance();
+		if (IsValid(Ability) && Ability->Implements<UBatchGameplayAbilityInterface>())
+		{
+			IBatchGameplayAbilityInterface::Execute_EndAbilityFromBatch(Ability);
+		}
+		else
+		{
+			const FString Message = IsValid(Ability) ? FString::Printf(TEXT("%s does not implement Batch Gameplay Ability Interface"), *GetNameSafe(Ability)) : "is invalid"; 
+			GAS_LOG_ARGS(Error, "Ability %s!", *Message);
+		}
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::EndServerAbilityRPCBatch(const FGameplayAbilitySpecHandle AbilityHandle)
+{
+	if (bCollectingAbilityRPCBatches)
+	{
+		const int32 BatchIndex = LocalServerAbilityRPCBatchData.IndexOfByKey(AbilityHandle);
+		if (BatchIndex != INDEX_NONE)
+		{
+			// Same as the default flow, but the batch is kept to be sent along with the others.
+			if (LocalServerAbilityRPCBatchData[BatchIndex].Started)
+			{
+				CollectedAbilityRPCBatches.Add(LocalServerAbilityRPCBatchData[BatchIndex]);
+			}
+
+			LocalServerAbilityRPCBatchData.RemoveAt(BatchIndex);
+			return;
+		}
+	}
+
+	Super::EndServerAbilityRPCBatch(AbilityHandle);
+}
+
+void UNinjaGASAbilitySystemComponent::SendCollectedAbilityRPCBatches()
+{
+	if (CollectedAbilityRPCBatches.IsEmpty())
+	{
+		return;
+	}
+	
+	if (CollectedAbilityRPCBatches.Num() == 1)
+	{
+		ServerAbilityRPCBatch(CollectedAbilityRPCBatches[0]);
+	}
+	else if (CollectedAbilityRPCBatches.Num() <= MaxAbilityRPCBatchesPerCall)
+	{
+		Server_AbilityRPCBatches(CollectedAbilityRPCBatches);
+	}
+	else
+	{
+		// Split, so the server accepts every call.
+		for (int32 Index = 0; Index < CollectedAbilityRPCBatches.Num(); Index += MaxAbilityRPCBatchesPerCall)
+		{
+			const int32 Count = FMath::Min(MaxAbilityRPCBatchesPerCall, CollectedAbilityRPCBatches.Num() - Index);
+			Server_AbilityRPCBatches(TArray<FServerAbilityRPCBatch>(CollectedAbilityRPCBatches.GetData() + Index, Count));
+		}
+	}
+
+	CollectedAbilityRPCBatches.Reset();
+}
+
+bool UNinjaGASAbilitySystemComponent::Server_AbilityRPCBatches_Validate(const TArray<FServerAbilityRPCBatch>& Batches)
+{
+	// Only structural checks, since failing validation disconnects the client.
+	return Batches.Num() <= MaxAbilityRPCBatchesPerCall;
+}
+
+void UNinjaGASAbilitySystemComponent::Server_AbilityRPCBatches_Implementation(const TArray<FServerAbilityRPCBatch>& Batches)
+{
+	// The internal handler takes a mutable reference, so we process a single copy of the array.
+	TArray<FServerAbilityRPCBatch> MutableBatches = Batches;
+	for (FServerAbilityRPCBatch& Batch : MutableBatches)
+	{
+		// Abilities may have been removed while the batch was in flight.
+		if (FindAbilitySpecFromHandle(Batch.AbilitySpecHandle) != nullptr)
+		{
+			ServerAbilityRPCBatch_Internal(Batch);
+		}
+	}
+}
+
+bool UNinjaGASAbilitySystemComponent::CanBatchAbilityRPCsForFrame() const
+{
+	// The authority activates abilities without any server RPCs, so there is nothing to batch.
+	return ShouldDoServerAbilityRPCBatch() && !IsOwnerActorAuthoritative() && IsValid(GetNinjaGASWorldSubsystem());
+}
+
+bool UNinjaGASAbilitySystemComponent::AddToFrameAbilityRPCBatch(const FGameplayAbilitySpecHandle AbilityHandle)
+{
+	if (!AbilityHandle.IsValid() || !CanBatchAbilityRPCsForFrame())
+	{
+		return false;
+	}
+
+	if (FrameAbilityRPCBatchHandles.Contains(AbilityHandle))
+	{
+		return true;
+	}
+
+	// Batching delays all RPCs from the ability until the end of the frame, so it must be requested by the ability.
+	const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(AbilityHandle);
+	const UNinjaGASGameplayAbility* Ability = AbilitySpec ? Cast<UNinjaGASGameplayAbility>(AbilitySpec->Ability) : nullptr;
+	if (!IsValid(Ability) || !Ability->ShouldBatchRPCsOnInput())
+	{
+		return false;
+	}
+
+	if (LocalServerAbilityRPCBatchData.FindByKey(AbilityHandle) != nullptr)
+	{
+		// Already batched by a scoped batcher, which also closes it.
+		return false;
+	}
+
+	if (FrameAbilityRPCBatchHandles.IsEmpty())
+	{
+		GetNinjaGASWorldSubsystem()->QueueAbilityRPCBatch(this);
+	}
+
+	BeginServerAbilityRPCBatch(AbilityHandle);
+	FrameAbilityRPCBatchHandles.Add(AbilityHandle);
+	return true;
+}
+
+void UNinjaGASAbilitySystemComponent::FlushFrameAbilityRPCBatch()
+{
+	if (FrameAbilityRPCBatchHandles.IsEmpty())
+	{
+		return;
+	}
+
+	// Swapped out, so abilities batched while closing are handled in the next frame.
+	const TArray<FGameplayAbilitySpecHandle> Handles = MoveTemp(FrameAbilityRPCBatchHandles);
+	FrameAbilityRPCBatchHandles.Reset();
+
+	// All abilities activated in this frame reach the server in a single call.
+	const bool bWasCollecting = bCollectingAbilityRPCBatches;
+	bCollectingAbilityRPCBatches = true;
+	
+	for (const FGameplayAbilitySpecHandle& Handle : Handles)
+	{
+		// A scoped batcher for the same ability may have closed the batch already.
+		if (LocalServerAbilityRPCBatchData.FindByKey(Handle) != nullptr)
+		{
+			EndServerAbilityRPCBatch(Handle);
+		}
+	}
+
+	bCollectingAbilityRPCBatches = bWasCollecting;
+	if (!bCollectingAbilityRPCBatches)
+	{
+		SendCollectedAbilityRPCBatches();
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::CancelAbilitiesByTags(const FGameplayTagContainer AbilityTags, const FGameplayTagContainer CancelFilterTags)
+{
+	CancelAbilities(&AbilityTags, &CancelFilterTags);
+}
+
+void UNinjaGASAbilitySystemComponent::ExecuteGameplayCueLocal(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const
+{
+	if (QueueLocalGameplayCue(GameplayCueTag, EGameplayCueEvent::Type::Executed, GameplayCueParameters))
+	{
+		return;
+	}
+	
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::Executed, GameplayCueParameters);
+}
+
+void UNinjaGASAbilitySystemComponent::AddGameplayCueLocally(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const
+{
+	if (QueueLocalGameplayCue(GameplayCueTag, EGameplayCueEvent::Type::OnActive, GameplayCueParameters))
+	{
+		return;
+	}
+	
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::OnActive, GameplayCueParameters);
+	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::WhileActive, GameplayCueParameters);
+}
+
+void UNinjaGASAbilitySystemComponent::RemoveGameplayCueLocally(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const
+{
+	if (QueueLocalGameplayCue(GameplayCueTag, EGameplayCueEvent::Type::Removed, GameplayCueParameters))
+	{
+		return;
+	}
+	
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::Removed, GameplayCueParameters);
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCueExecuted(const FGameplayTag GameplayCueTag, const FPredictionKey PredictionKey, const FGameplayEffectContextHandle EffectContext)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCueExecuted(GameplayCueTag, PredictionKey, EffectContext);
+		return;
+	}
+
+	// Same parameters the multicast would build from the context, when invoking the cue.
+	FGameplayCueParameters GameplayCueParameters(EffectContext);
+	GameplayCueParameters.NormalizedMagnitude = 1.f;
+	GameplayCueParameters.RawMagnitude = 0.f;
+	BatchGameplayCue(GameplayCueTag, PredictionKey, ENinjaGameplayCueBatchEvent::Executed, GameplayCueParameters);
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCuesExecuted(const FGameplayTagContainer GameplayCueTags, const FPredictionKey PredictionKey, const FGameplayEffectContextHandle EffectContext)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCuesExecuted(GameplayCueTags, PredictionKey, EffectContext);
+		return;
+	}
+
+	for (const FGameplayTag& GameplayCueTag : GameplayCueTags)
+	{
+		Call_InvokeGameplayCueExecuted(GameplayCueTag, PredictionKey, EffectContext);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCueExecuted_WithParams(const FGameplayTag GameplayCueTag, const FPredictionKey PredictionKey, const FGameplayCueParameters GameplayCueParameters)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCueExecuted_WithParams(GameplayCueTag, PredictionKey, GameplayCueParameters);
+		return;
+	}
+
+	BatchGameplayCue(GameplayCueTag, PredictionKey, ENinjaGameplayCueBatchEvent::Executed, GameplayCueParameters);
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCuesExecuted_WithParams(const FGameplayTagContainer GameplayCueTags, const FPredictionKey PredictionKey, const FGameplayCueParameters GameplayCueParameters)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCuesExecuted_WithParams(GameplayCueTags, PredictionKey, GameplayCueParameters);
+		return;
+	}
+
+	for (const FGameplayTag& GameplayCueTag : GameplayCueTags)
+	{
+		BatchGameplayCue(GameplayCueTag, PredictionKey, ENinjaGameplayCueBatchEvent::Executed, GameplayCueParameters);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCueAdded_WithParams(const FGameplayTag GameplayCueTag, const FPredictionKey PredictionKey, const FGameplayCueParameters Parameters)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCueAdded_WithParams(GameplayCueTag, PredictionKey, Parameters);
+		return;
+	}
+
+	BatchGameplayCue(GameplayCueTag, PredictionKey, ENinjaGameplayCueBatchEvent::Added, Parameters);
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCueAddedAndWhileActive_WithParams(const FGameplayTag GameplayCueTag, const FPredictionKey PredictionKey, const FGameplayCueParameters GameplayCueParameters)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCueAddedAndWhileActive_WithParams(GameplayCueTag, PredictionKey, GameplayCueParameters);
+		return;
+	}
+
+	BatchGameplayCue(GameplayCueTag, PredictionKey, ENinjaGameplayCueBatchEvent::AddedAndWhileActive, GameplayCueParameters);
+}
+
+void UNinjaGASAbilitySystemComponent::Call_InvokeGameplayCuesAddedAndWhileActive_WithParams(const FGameplayTagContainer GameplayCueTags, const FPredictionKey PredictionKey, const FGameplayCueParameters GameplayCueParameters)
+{
+	if (!CanBatchGameplayCues())
+	{
+		Super::Call_InvokeGameplayCuesAddedAndWhileActive_WithParams(GameplayCueTags, PredictionKey, GameplayCueParameters);
+		return;
+	}
+
+	for (const FGameplayTag& GameplayCueTag : GameplayCueTags)
+	{
+		BatchGameplayCue(GameplayCueTag, PredictionKey, ENinjaGameplayCueBatchEvent::AddedAndWhileActive, GameplayCueParameters);
+	}
+}
+
+bool UNinjaGASAbilitySystemComponent::CanBatchGameplayCues() const
+{
+	// Standalone games have no RPCs to save, so cues are not delayed until the end of the frame.
+	return bBatchReplicatedGameplayCues && IsOwnerActorAuthoritative() && GetNetMode() != NM_Standalone
+		&& IsValid(GetNinjaGASWorldSubsystem());
+}
+
+void UNinjaGASAbilitySystemComponent::BatchGameplayCue(const FGameplayTag& GameplayCueTag, const FPredictionKey& PredictionKey,
+	const ENinjaGameplayCueBatchEvent EventType, const FGameplayCueParameters& GameplayCueParameters)
+{
+	if (PendingGameplayCueBatch.Entries.Num() >= FMath::Max(GGameplayCueBatchMaxEntries, 1))
+	{
+		SendGameplayCueBatch();
+	}
+	
+	if (!PendingGameplayCueBatch.Add(GameplayCueTag, PredictionKey, EventType, GameplayCueParameters))
+	{
+		SendGameplayCueBatch();
+		PendingGameplayCueBatch.Add(GameplayCueTag, PredictionKey, EventType, GameplayCueParameters);
+	}
+
+	if (!bGameplayCueBatchQueued)
+	{
+		GetNinjaGASWorldSubsystem()->QueueGameplayCueBatch(this);
+		bGameplayCueBatchQueued = true;
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::FlushGameplayCueBatch()
+{
+	bGameplayCueBatchQueued = false;
+	SendGameplayCueBatch();
+}
+
+void UNinjaGASAbilitySystemComponent::SendGameplayCueBatch()
+{
+	if (PendingGameplayCueBatch.IsEmpty())
+	{
+		return;
+	}
+
+	if (PendingGameplayCueBatch.Entries.Num() == 1)
+	{
+		const FNinjaGameplayCueBatchEntry& Entry = PendingGameplayCueBatch.Entries[0];
+		const FGameplayCueParameters& Parameters = PendingGameplayCueBatch.Parameters[Entry.ParametersIndex];
+		
+		switch (Entry.EventType)
+		{
+			case ENinjaGameplayCueBatchEvent::Executed:
+				Super::Call_InvokeGameplayCueExecuted_WithParams(Entry.GameplayCueTag, Entry.PredictionKey, Parameters);
+				break;
+			case ENinjaGameplayCueBatchEvent::Added:
+				Super::Call_InvokeGameplayCueAdded_WithParams(Entry.GameplayCueTag, Entry.PredictionKey, Parameters);
+				break;
+			case ENinjaGameplayCueBatchEvent::AddedAndWhileActive:
+				Super::Call_InvokeGameplayCueAddedAndWhileActive_WithParams(Entry.GameplayCueTag, Entry.PredictionKey, Parameters);
+				break;
+		}
+	}
+	else
+	{
+		NetMulticast_InvokeGameplayCueBatch(PendingGameplayCueBatch);
+	}
+
+	PendingGameplayCueBatch.Reset();
+}
+
+void UNinjaGASAbilitySystemComponent::NetMulticast_InvokeGameplayCueBatch_Implementation(const FNinjaGameplayCueBatch& Batch)
+{
+	const bool bIsAuthority = IsOwnerActorAuthoritative();
+	const bool bIsLocallyControlledPlayer = AbilityActorInfo.IsValid() && AbilityActorInfo->IsLocallyControlledPlayer();
+	
+	for (const FNinjaGameplayCueBatchEntry& Entry : Batch.Entries)
+	{
+		if (!Batch.Parameters.IsValidIndex(Entry.ParametersIndex))
+		{
+			continue;
+		}
+
+		// Same checks as the individual multicasts, so cues predicted by this client are not invoked twice.
+		const FGameplayCueParameters& Parameters = Batch.Parameters[Entry.ParametersIndex];
+		const bool bPredictedLocally = Entry.PredictionKey.IsLocalClientKey();
+		
+		switch (Entry.EventType)
+		{
+			case ENinjaGameplayCueBatchEvent::Executed:
+				if (bIsAuthority || !bPredictedLocally)
+				{
+					InvokeGameplayCueEvent(Entry.GameplayCueTag, EGameplayCueEvent::Executed, Parameters);
+				}
+				break;
+			case ENinjaGameplayCueBatchEvent::Added:
+			{
+				// Mixed replication sends the real event to the autonomous proxy through the replicated effect.
+				const bool bIsMixedReplicationFromServer = ReplicationMode == EGameplayEffectReplicationMode::Mixed
+					&& Entry.PredictionKey.IsServerInitiatedKey() && bIsLocallyControlledPlayer;
+				
+				if (bIsAuthority || (!bPredictedLocally && !bIsMixedReplicationFromServer))
+				{
+					InvokeGameplayCueEvent(Entry.GameplayCueTag, EGameplayCueEvent::OnActive, Parameters);
+				}
+				break;
+			}
+			case ENinjaGameplayCueBatchEvent::AddedAndWhileActive:
+				if (bIsAuthority || !bPredictedLocally)
+				{
+					InvokeGameplayCueEvent(Entry.GameplayCueTag, EGameplayCueEvent::OnActive, Parameters);
+					InvokeGameplayCueEvent(Entry.GameplayCueTag, EGameplayCueEvent::WhileActive, Parameters);
+				}
+				break;
+		}
+	}
+}
+
+const FGameplayAbilitySpec* UNinjaGASAbilitySystemComponent::FindAbilitySpecByHandle(const FGameplayAbilitySpecHandle Handle) const
+{
+	if (!Handle.IsValid())
+	{
+		return nullptr;
+	}
+
+	const TArray<FGameplayAbilitySpec>& Specs = ActivatableAbilities.Items;
+	if (bAbilitySpecIndicesDirty || AbilitySpecIndices.Num() != Specs.Num())
+	{
+		RebuildAbilitySpecIndices();
+	}
+
+	const int32* Index = AbilitySpecIndices.Find(Handle);
+	if (Index != nullptr && Specs.IsValidIndex(*Index) && Specs[*Index].Handle == Handle)
+	{
+		return &Specs[*Index];
+	}
+
+	if (Index != nullptr)
+	{
+		// The array was reordered without a give/remove notification (i.e. replication). Rebuild and retry once.
+		RebuildAbilitySpecIndices();
+		Index = AbilitySpecIndices.Find(Handle);
+		if (Index != nullptr && Specs.IsValidIndex(*Index))
+		{
+			return &Specs[*Index];
+		}
+	}
+	
+	return nullptr;
+}
+
+const FGameplayAbilitySpec* UNinjaGASAbilitySystemComponent::FindAbilitySpecByClass(const TSubclassOf<UGameplayAbility>& AbilityClass) const
+{
+	if (!IsValid(AbilityClass))
+	{
+		return nullptr;
+	}
+
+	const TArray<FGameplayAbilitySpecHandle>* Handles = AbilityHandlesByClass.Find(TObjectKey<UClass>(AbilityClass.Get()));
+	if (Handles != nullptr)
+	{
+		for (const FGameplayAbilitySpecHandle& Handle : *Handles)
+		{
+			const FGameplayAbilitySpec* Spec = FindAbilitySpecByHandle(Handle);
+			if (Spec != nullptr && Spec->Ability && Spec->Ability->GetClass() == AbilityClass)
+			{
+				return Spec;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void UNinjaGASAbilitySystemComponent::FindAbilitySpecsByTags(const FGameplayTagContainer& Tags, TArray<const FGameplayAbilitySpec*>& OutSpecs, const bool bExactMatch) const
+{
+	if (Tags.IsEmpty())
+	{
+		// Same as the linear search: an empty container matches every ability.
+		for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+		{
+			if (Spec.Ability)
+			{
+				OutSpecs.Add(&Spec);
+			}
+		}
+		return;
+	}
+
+	// Tags are indexed with their parents, so any requested tag narrows the candidates. Use the smallest bucket.
+	const TArray<FGameplayAbilitySpecHandle>* Candidates = nullptr;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		const TArray<FGameplayAbilitySpecHandle>* Handles = AbilityHandlesByTag.Find(Tag);
+		if (Handles == nullptr)
+		{
+			return;
+		}
+
+		if (Candidates == nullptr || Handles->Num() < Candidates->Num())
+		{
+			Candidates = Handles;
+		}
+	}
+
+	check(Candidates);
+	for (const FGameplayAbilitySpecHandle& Handle : *Candidates)
+	{
+		const FGameplayAbilitySpec* Spec = FindAbilitySpecByHandle(Handle);
+		if (Spec == nullptr || !Spec->Ability)
+		{
+			continue;
+		}
+
+		const FGameplayTagContainer& AssetTags = Spec->Ability->GetAssetTags();
+		if (bExactMatch ? AssetTags.HasAllExact(Tags) : AssetTags.HasAll(Tags))
+		{
+			OutSpecs.Add(Spec);
+		}
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::FindAbilitySpecsByInputID(const int32 InputID, TArray<const FGameplayAbilitySpec*>& OutSpecs) const
+{
+	const TArray<FGameplayAbilitySpecHandle>* Handles = AbilityHandlesByInputID.Find(InputID);
+	if (Handles == nullptr)
+	{
+		return;
+	}
+
+	for (const FGameplayAbilitySpecHandle& Handle : *Handles)
+	{
+		const FGameplayAbilitySpec* Spec = FindAbilitySpecByHandle(Handle);
+		if (Spec != nullptr && Spec->InputID == InputID)
+		{
+			OutSpecs.Add(Spec);
+		}
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::RefreshAbilityIndices()
+{
+	AbilityHandlesByClass.Reset();
+	AbilityHandlesByTag.Reset();
+	AbilityHandlesByInputID.Reset();
+	IndexedInputIDs.Reset();
+
+	for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		IndexAbilitySpec(Spec);
+	}
+
+	RebuildAbilitySpecIndices();
+}
+
+bool UNinjaGASAbilitySystemComponent::IsAbilityClassActive(const TSubclassOf<UGameplayAbility>& AbilityClass) const
+{
+	return IsValid(AbilityClass) && ActiveAbilityClassCounts.Contains(TObjectKey<UClass>(AbilityClass.Get()));
+}
+
+bool UNinjaGASAbilitySystemComponent::HasActiveAbilityWithTags(const FGameplayTagContainer& Tags, const bool bExactMatch) const
+{
+	if (ActiveAbilityRecords.IsEmpty())
+	{
+		return false;
+	}
+	
+	if (Tags.IsEmpty())
+	{
+		// Same as the linear search: an empty container matches every ability.
+		return true;
+	}
+
+	const TMap<FGameplayTag, int32>& TagCounts = bExactMatch ? ActiveAbilityExactTagCounts : ActiveAbilityTagCounts;
+	for (const FGameplayTag& Tag : Tags)
+	{
+		if (!TagCounts.Contains(Tag))
+		{
+			return false;
+		}
+	}
+
+	if (Tags.Num() == 1)
+	{
+		return true;
+	}
+
+	// All tags are active, but they must belong to the same ability.
+	for (const TPair<FGameplayAbilitySpecHandle, FNinjaActiveAbilityRecord>& Entry : ActiveAbilityRecords)
+	{
+		const FGameplayTagContainer& AssetTags = Entry.Value.AssetTags;
+		if (bExactMatch ? AssetTags.HasAllExact(Tags) : AssetTags.HasAll(Tags))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UNinjaGASAbilitySystemComponent::HasActiveAbilityWithInputID(const int32 InputID) const
+{
+	return InputID != INDEX_NONE && ActiveAbilityInputIDCounts.Contains(InputID);
+}
+
+void UNinjaGASAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
+{
+	Super::NotifyAbilityActivated(Handle, Ability);
+	SyncActiveAbility(Handle);
+	RecordFirstActivation(Handle);
+}
+
+void UNinjaGASAbilitySystemComponent::NotifyAbilityEnded(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const bool bWasCancelled)
+{
+	// The base implementation may remove the spec, which is handled by OnRemoveAbility.
+	Super::NotifyAbilityEnded(Handle, Ability, bWasCancelled);
+	SyncActiveAbility(Handle);
+}
+
+void UNinjaGASAbilitySystemComponent::SyncActiveAbility(const FGameplayAbilitySpecHandle Handle)
+{
+	const FGameplayAbilitySpec* Spec = FindAbilitySpecByHandle(Handle);
+	const bool bIsActive = Spec != nullptr && Spec->Ability && Spec->IsActive();
+	const bool bIsTracked = ActiveAbilityRecords.Contains(Handle);
+
+	if (!bIsActive)
+	{
+		if (bIsTracked)
+		{
+			ReleaseActiveAbility(Handle);
+		}
+		return;
+	}
+
+	if (bIsTracked)
+	{
+		return;
+	}
+
+	FNinjaActiveAbilityRecord& Record = ActiveAbilityRecords.Add(Handle);
+	Record.AbilityClass = Spec->Ability->GetClass();
+	Record.AssetTags = Spec->Ability->GetAssetTags();
+	Record.IndexedTags = Record.AssetTags.GetGameplayTagParents();
+	Record.InputID = Spec->InputID;
+
+	++ActiveAbilityClassCounts.FindOrAdd(Record.AbilityClass);
+	
+	for (const FGameplayTag& Tag : Record.AssetTags)
+	{
+		++ActiveAbilityExactTagCounts.FindOrAdd(Tag);
+	}
+	
+	for (const FGameplayTag& Tag : Record.IndexedTags)
+	{
+		++ActiveAbilityTagCounts.FindOrAdd(Tag);
+	}
+
+	if (Record.InputID != INDEX_NONE)
+	{
+		++ActiveAbilityInputIDCounts.FindOrAdd(Record.InputID);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::ReleaseActiveAbility(const FGameplayAbilitySpecHandle Handle)
+{
+	FNinjaActiveAbilityRecord Record;
+	if (!ActiveAbilityRecords.RemoveAndCopyValue(Handle, Record))
+	{
+		return;
+	}
+
+	auto DecrementCount = [](auto& Counts, const auto& Key)
+	{
+		if (int32* Count = Counts.Find(Key))
+		{
+			if (--(*Count) <= 0)
+			{
+				Counts.Remove(Key);
+			}
+		}
+	};
+
+	DecrementCount(ActiveAbilityClassCounts, Record.AbilityClass);
+	
+	for (const FGameplayTag& Tag : Record.AssetTags)
+	{
+		DecrementCount(ActiveAbilityExactTagCounts, Tag);
+	}
+	
+	for (const FGameplayTag& Tag : Record.IndexedTags)
+	{
+		DecrementCount(ActiveAbilityTagCounts, Tag);
+	}
+
+	if (Record.InputID != INDEX_NONE)
+	{
+		DecrementCount(ActiveAbilityInputIDCounts, Record.InputID);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+	IndexAbilitySpec(AbilitySpec);
+	PreloadAbilityDependencies(AbilitySpec);
+}
+
+void UNinjaGASAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	TSharedPtr<FStreamableHandle> DependencyHandle;
+	if (AbilityDependencyHandles.RemoveAndCopyValue(AbilitySpec.Handle, DependencyHandle) && DependencyHandle.IsValid())
+	{
+		DependencyHandle->ReleaseHandle();
+	}
+	
+	FirstActivatedAbilities.Remove(AbilitySpec.Handle);
+	ReleaseActiveAbility(AbilitySpec.Handle);
+	UnindexAbilitySpec(AbilitySpec);
+	Super::OnRemoveAbility(AbilitySpec);
+}
+
+UNinjaGASSubsystem* UNinjaGASAbilitySystemComponent::GetNinjaGASSubsystem() const
+{
+	const UWorld* World = GetWorld();
+	return UGameInstance::GetSubsystem<UNinjaGASSubsystem>(World ? World->GetGameInstance() : nullptr);
+}
+
+UNinjaGASWorldSubsystem* UNinjaGASAbilitySystemComponent::GetNinjaGASWorldSubsystem() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UNinjaGASWorldSubsystem>() : nullptr;
+}
+
+bool UNinjaGASAbilitySystemComponent::QueueLocalGameplayCue(const FGameplayTag GameplayCueTag, const EGameplayCueEvent::Type EventType, const FGameplayCueParameters& GameplayCueParameters) const
+{
+	if (!bQueueLocalGameplayCues)
+	{
+		return false;
+	}
 
-	bEnableAbilityBatchRPC = true;
-	CurrentAbilitySetup = nullptr;
+	UNinjaGASWorldSubsystem* WorldSubsystem = GetNinjaGASWorldSubsystem();
+	if (!IsValid(WorldSubsystem))
+	{
+		return false;
+	}
+
+	WorldSubsystem->QueueLocalGameplayCue(GetOwner(), GameplayCueTag, EventType, GameplayCueParameters);
+	return true;
 }
 
-void UNinjaGASAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor)
+bool UNinjaGASAbilitySystemComponent::ShouldTickCentrally() const
 {
-	// Guard condition to ensure we should clear/init for this new Avatar Actor.
-	const bool bAvatarHasChanged = AbilityActorInfo && AbilityActorInfo->AvatarActor != InAvatarActor && InAvatarActor != nullptr;
-	
-	Super::InitAbilityActorInfo(InOwnerActor, InAvatarActor);
+	return !bHibernating && Super::GetShouldTick();
+}
 
-	// Apply the new defaults obtained from the owner's interface.
-	if (bAvatarHasChanged)
+void UNinjaGASAbilitySystemComponent::TickCentrally(const float DeltaTime)
+{
+	TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+}
+
+float UNinjaGASAbilitySystemComponent::GetCentralTickInterval(const float DistanceToViewer) const
+{
+	for (const FNinjaTickDistanceBand& Band : CentralTickDistanceBands)
 	{
-		InitializeDefaults(InAvatarActor);
-		OnAbilitySystemAvatarChanged.Broadcast(InAvatarActor);
+		if (DistanceToViewer <= Band.MaxDistance)
+		{
+			return Band.TickInterval;
+		}
 	}
+
+	return CentralTickDistanceBands.IsEmpty() ? 0.f : CentralTickDistanceBands.Last().TickInterval;
 }
 
-void UNinjaGASAbilitySystemComponent::InitializeDefaults(const AActor* NewAvatarActor)
+bool UNinjaGASAbilitySystemComponent::CanHibernate() const
 {
-	if (!IsValid(NewAvatarActor) || !IsOwnerActorAuthoritative())
+	if (!bEnableHibernation || !IsOwnerActorAuthoritative())
 	{
-		return;
+		return false;
 	}
 
-	const IAbilitySystemDefaultsInterface* Defaults = Cast<IAbilitySystemDefaultsInterface>(NewAvatarActor);
-	if (Defaults == nullptr || !Defaults->HasAbilityData())
+	const APawn* AvatarPawn = Cast<APawn>(GetAvatarActor());
+	return !IsValid(AvatarPawn) || !AvatarPawn->IsPlayerControlled();
+}
+
+void UNinjaGASAbilitySystemComponent::SetHibernating(const bool bNewHibernating)
+{
+	if (bNewHibernating == bHibernating || (bNewHibernating && !CanHibernate()))
 	{
-		// Use the defaults provided by this own class.
-		Defaults = Cast<IAbilitySystemDefaultsInterface>(this);
+		return;
 	}
 
-	const UNinjaGASDataAsset* AbilityData = Defaults->GetAbilityData();
-	if (IsValid(AbilityData) && AbilityData != CurrentAbilitySetup)
+	if (bNewHibernating)
 	{
-		ClearDefaults();
-		CurrentAbilitySetup = AbilityData;
-		InitializeFromData(NewAvatarActor, AbilityData);
+		EnterHibernation();
+	}
+	else
+	{
+		ExitHibernation();
 	}
 }
 
-void UNinjaGASAbilitySystemComponent::InitializeFromData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData)
+void UNinjaGASAbilitySystemComponent::UpdateHibernation(const float DistanceToViewer)
 {
-	if (!IsValid(AbilityData) || !IsOwnerActorAuthoritative())
+	if (HibernationDistance <= 0.f)
 	{
 		return;
 	}
 
-	const AActor* CurrentAvatar = GetAvatarActor();
-	if (NewAvatarActor != CurrentAvatar)
+	if (bHibernating)
 	{
-		return;
+		const float EffectiveWakeDistance = WakeDistance > 0.f ? FMath::Min(WakeDistance, HibernationDistance) : HibernationDistance;
+		if (DistanceToViewer < EffectiveWakeDistance)
+		{
+			SetHibernating(false);
+		}
 	}
-	
-	const TArray<FDefaultAttributeSet>& AttributeSets = AbilityData->DefaultAttributeSets;
-	InitializeAttributeSets(AttributeSets);
+	else if (DistanceToViewer >= HibernationDistance)
+	{
+		SetHibernating(true);
+	}
+}
 
-	const TArray<FDefaultGameplayEffect>& GameplayEffects = AbilityData->DefaultGameplayEffects;
-	InitializeGameplayEffects(GameplayEffects);
+void UNinjaGASAbilitySystemComponent::EnterHibernation()
+{
+	UWorld* World = GetWorld();
+	AActor* Owner = GetOwner();
+	if (!IsValid(World) || !IsValid(Owner))
+	{
+		return;
+	}
 
-	const TArray<FDefaultGameplayAbility>& GameplayAbilities = AbilityData->DefaultGameplayAbilities;
-	InitializeGameplayAbilities(GameplayAbilities);
+	FTimerManager& TimerManager = World->GetTimerManager();
+	HibernationStartTime = World->GetTimeSeconds();
+	HibernatedPeriodicEffects.Reset();
 
-	const FGameplayTagContainer& InitialGameplayTags = AbilityData->InitialGameplayTags; 
-	if (InitialGameplayTags.IsValid())
+	// Duration timers are paused too, so an effect cannot expire before its missing periods are executed.
+	for (const FActiveGameplayEffect& ActiveEffect : &ActiveGameplayEffects)
 	{
-		AddReplicatedLooseGameplayTags(InitialGameplayTags);
+		if (ActiveEffect.IsPendingRemove || ActiveEffect.GetPeriod() <= 0.f || !ActiveEffect.PeriodHandle.IsValid())
+		{
+			continue;
+		}
+
+		FHibernatedPeriodicEffect& HibernatedEffect = HibernatedPeriodicEffects.AddDefaulted_GetRef();
+		HibernatedEffect.Handle = ActiveEffect.Handle;
+		HibernatedEffect.PeriodRemaining = TimerManager.GetTimerRemaining(ActiveEffect.PeriodHandle);
+
+		TimerManager.PauseTimer(ActiveEffect.PeriodHandle);
+		TimerManager.PauseTimer(ActiveEffect.DurationHandle);
 	}
+
+	PreHibernationNetUpdateFrequency = Owner->GetNetUpdateFrequency();
+	PreHibernationMinNetUpdateFrequency = Owner->GetMinNetUpdateFrequency();
+	Owner->SetNetUpdateFrequency(FMath::Min(HibernationNetUpdateFrequency, PreHibernationNetUpdateFrequency));
+	Owner->SetMinNetUpdateFrequency(FMath::Min(HibernationNetUpdateFrequency, PreHibernationMinNetUpdateFrequency));
+
+	bHibernating = true;
+	SetComponentTickEnabled(false);
 	
-	UE_LOG(LogAbilitySystemComponent, Log, TEXT("Initialized ASC defaults from %s: [ Attribute Sets: %d, Effects: %d, Abilities: %d, Tags %d ]."),
-		*GetNameSafe(AbilityData), AddedAttributes.Num(), DefaultEffectHandles.Num(), DefaultAbilityHandles.Num(), InitialGameplayTags.Num());	
+	UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Ability System is hibernating, with %d periodic effects paused."),
+		*GetNameSafe(GetAvatarActor()), HibernatedPeriodicEffects.Num());
 }
 
-void UNinjaGASAbilitySystemComponent::InitializeAttributeSets(const TArray<FDefaultAttributeSet>& AttributeSets)
+void UNinjaGASAbilitySystemComponent::ExitHibernation()
 {
-	for (const FDefaultAttributeSet& Entry : AttributeSets)
+	bHibernating = false;
+	
+	UWorld* World = GetWorld();
+	if (!IsValid(World))
 	{
-		const TSubclassOf<UAttributeSet> AttributeSetClass = Entry.AttributeSetClass;
-		const UDataTable* AttributeTable = Entry.AttributeTable;
-		
-		UAttributeSet* NewAttributeSet = NewObject<UAttributeSet>(GetOwner(), AttributeSetClass);
-		if (GetSpawnedAttributes().Contains(NewAttributeSet))
+		HibernatedPeriodicEffects.Reset();
+		return;
+	}
+
+	FTimerManager& TimerManager = World->GetTimerManager();
+	const double CurrentTime = World->GetTimeSeconds();
+	int32 TotalExecutions = 0;
+	
+	for (const FHibernatedPeriodicEffect& HibernatedEffect : HibernatedPeriodicEffects)
+	{
+		const FActiveGameplayEffect* ActiveEffect = ActiveGameplayEffects.GetActiveGameplayEffect(HibernatedEffect.Handle);
+		if (ActiveEffect == nullptr || ActiveEffect->IsPendingRemove)
 		{
-			UE_LOG(LogAbilitySystemComponent, Warning, TEXT("Discarding Attribute Set %s since it was already spawned."), *GetNameSafe(NewAttributeSet));
+			continue;
 		}
-		else
+
+		// Periods are only caught up until the effect's natural end, which is still based on its start time.
+		const float Period = ActiveEffect->GetPeriod();
+		const float EndTime = ActiveEffect->GetEndTime();
+		const double CatchUpTime = EndTime > 0.f ? FMath::Min(CurrentTime, static_cast<double>(EndTime)) : CurrentTime;
+		const double ElapsedTime = FMath::Max(CatchUpTime - HibernationStartTime, 0.0);
+
+		int32 Executions = 0;
+		double TimeSinceLastExecution = 0.0;
+		if (ElapsedTime >= HibernatedEffect.PeriodRemaining)
 		{
-			if (IsValid(AttributeTable))
-			{
-				NewAttributeSet->InitFromMetaDataTable(AttributeTable);
-				UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("Initialized Attribute Set %s with %s."), *GetNameSafe(NewAttributeSet), *GetNameSafe(AttributeTable));
-			}
+			TimeSinceLastExecution = ElapsedTime - HibernatedEffect.PeriodRemaining;
+			Executions = 1 + FMath::FloorToInt32(TimeSinceLastExecution / Period);
+			TimeSinceLastExecution = FMath::Fmod(TimeSinceLastExecution, static_cast<double>(Period));
+		}
 
-			AddAttributeSetSubobject(NewAttributeSet);
-			AddedAttributes.Add(NewAttributeSet);			
+		for (int32 Index = 0; Index < Executions && ActiveGameplayEffects.GetActiveGameplayEffect(HibernatedEffect.Handle); ++Index)
+		{
+			ExecutePeriodicEffect(HibernatedEffect.Handle);
 		}
-	}		
-}
 
-void UNinjaGASAbilitySystemComponent::InitializeGameplayEffects(const TArray<FDefaultGameplayEffect>& GameplayEffects)
-{
-	const int32 GameplayEffectCount = GameplayEffects.Num(); 
-	if (GameplayEffectCount > 0)
-	{
-		const int32 NewSize = DefaultEffectHandles.Num() + GameplayEffectCount;  
-		DefaultEffectHandles.Reserve(NewSize);
+		TotalExecutions += Executions;
 		
-		for (const FDefaultGameplayEffect& Entry : GameplayEffects)
+		FActiveGameplayEffect* MutableEffect = ActiveGameplayEffects.GetActiveGameplayEffect(HibernatedEffect.Handle);
+		if (MutableEffect == nullptr || MutableEffect->IsPendingRemove)
 		{
-			const TSubclassOf<UGameplayEffect> GameplayEffectClass = Entry.GameplayEffectClass;
-			FActiveGameplayEffectHandle Handle = ApplyGameplayEffectClassToSelf(GameplayEffectClass, Entry.Level);
-			DefaultEffectHandles.Add(Handle);
+			continue;
+		}
+
+		// Restarts the period in the same phase it would have been, had the effect never been paused.
+		const double FirstDelay = Executions > 0 ? Period - TimeSinceLastExecution : HibernatedEffect.PeriodRemaining - ElapsedTime;
+		const FTimerDelegate PeriodDelegate = FTimerDelegate::CreateUObject(this, &UAbilitySystemComponent::ExecutePeriodicEffect, HibernatedEffect.Handle);
+		TimerManager.SetTimer(MutableEffect->PeriodHandle, PeriodDelegate, Period, true, FMath::Max(static_cast<float>(FirstDelay), KINDA_SMALL_NUMBER));
+
+		// Expires the effect if its duration elapsed, or restarts the duration timer for the remaining time.
+		if (EndTime > 0.f)
+		{
+			TimerManager.UnPauseTimer(MutableEffect->DurationHandle);
+			CheckDurationExpired(HibernatedEffect.Handle);
 		}
 	}
+
+	UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Ability System woke up after %.2fs, with %d periodic executions caught up."),
+		*GetNameSafe(GetAvatarActor()), CurrentTime - HibernationStartTime, TotalExecutions);
+	
+	HibernatedPeriodicEffects.Reset();
+
+	if (AActor* Owner = GetOwner())
+	{
+		Owner->SetNetUpdateFrequency(PreHibernationNetUpdateFrequency);
+		Owner->SetMinNetUpdateFrequency(PreHibernationMinNetUpdateFrequency);
+		Owner->ForceNetUpdate();
+	}
+
+	if (!bCentrallyTicked)
+	{
+		UpdateShouldTick();
+	}
 }
 
-void UNinjaGASAbilitySystemComponent::InitializeGameplayAbilities(const TArray<FDefaultGameplayAbility>& GameplayAbilities)
+void UNinjaGASAbilitySystemComponent::GetAbilityDependencyPaths(const UClass* AbilityClass, TArray<FSoftObjectPath>& OutPaths) const
 {
-	const int32 GameplayAbilityCount = GameplayAbilities.Num(); 
-	if (GameplayAbilityCount > 0)
+	UNinjaGASSubsystem* Subsystem = GetNinjaGASSubsystem();
+	if (!IsValid(Subsystem) || !IsValid(AbilityClass))
 	{
-		const int32 NewSize = DefaultAbilityHandles.Num() + GameplayAbilityCount; 
-		DefaultAbilityHandles.Reserve(NewSize);
-		
-		for (const FDefaultGameplayAbility& Entry : GameplayAbilities)
-		{
-			const TSubclassOf<UGameplayAbility> GameplayAbilityClass = Entry.GameplayAbilityClass;
-			FGameplayAbilitySpecHandle Handle = GiveAbilityFromClass(GameplayAbilityClass, Entry.Level, Entry.Input);
-			DefaultAbilityHandles.Add(Handle);
-		}
+		return;
+	}
+
+	const FNinjaAbilityDependencies& Dependencies = Subsystem->GetAbilityDependencies(AbilityClass);
+	OutPaths.Append(Dependencies.AssetPaths);
+
+	// Dedicated servers never execute cues, so there is no reason to keep their notifies around.
+	if (!IsRunningDedicatedServer())
+	{
+		OutPaths.Append(Dependencies.CuePaths);
 	}
 }
 
-FActiveGameplayEffectHandle UNinjaGASAbilitySystemComponent::ApplyGameplayEffectClassToSelf(const TSubclassOf<UGameplayEffect> EffectClass, const float Level)
+void UNinjaGASAbilitySystemComponent::PreloadAbilityDependencies(const FGameplayAbilitySpec& AbilitySpec)
 {
-	FActiveGameplayEffectHandle Handle;
-    
-	if (IsValid(EffectClass))
+	// Specs only replicate to the owning client, so this runs on the server and the owner.
+	if (!AbilitySpec.Ability || AbilityDependencyHandles.Contains(AbilitySpec.Handle))
 	{
-		FGameplayEffectContextHandle ContextHandle = MakeEffectContext();
-		ContextHandle.AddSourceObject(GetOwner());
-
-		const FGameplayEffectSpecHandle SpecHandle = MakeOutgoingSpec(EffectClass, Level, ContextHandle);
-		if (SpecHandle.IsValid())
-		{
-			Handle = ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
-			
-			UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Effect '%s' granted at level %f."),
-				*GetNameSafe(GetAvatarActor()), *GetNameSafe(EffectClass), Level);
-		}
+		return;
 	}
 
-	return Handle;	
+	TArray<FSoftObjectPath> Paths;
+	GetAbilityDependencyPaths(AbilitySpec.Ability->GetClass(), Paths);
+	Paths.RemoveAllSwap([](const FSoftObjectPath& Path) { return Path.ResolveObject() != nullptr; });
+	
+	if (!Paths.IsEmpty())
+	{
+		const TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+		AbilityDependencyHandles.Add(AbilitySpec.Handle, Handle);
+	}
 }
 
-FGameplayAbilitySpecHandle UNinjaGASAbilitySystemComponent::GiveAbilityFromClass(const TSubclassOf<UGameplayAbility> AbilityClass, const int32 Level, const int32 Input)
+void UNinjaGASAbilitySystemComponent::RecordFirstActivation(const FGameplayAbilitySpecHandle Handle)
 {
-	FGameplayAbilitySpecHandle Handle;
-
-	if (IsValid(AbilityClass))
+	if (FirstActivatedAbilities.Contains(Handle))
 	{
-		const FGameplayAbilitySpec NewAbilitySpec(FGameplayAbilitySpec(AbilityClass, Level, Input, GetOwner()));
-		Handle = GiveAbility(NewAbilitySpec);
+		return;
+	}
 
-		UE_LOG(LogAbilitySystemComponent, Log, TEXT("[%s] Ability '%s' %s at level %d."),
-			*GetNameSafe(GetAvatarActor()), *GetNameSafe(AbilityClass),
-			Handle.IsValid() ? TEXT("successfully granted") : TEXT("failed to be granted"), Level);
+	const FGameplayAbilitySpec* Spec = FindAbilitySpecByHandle(Handle);
+	UNinjaGASSubsystem* Subsystem = GetNinjaGASSubsystem();
+	if (Spec == nullptr || !Spec->Ability || !IsValid(Subsystem))
+	{
+		return;
 	}
 
-	return Handle;
+	FirstActivatedAbilities.Add(Handle);
+
+	TArray<FSoftObjectPath> Paths;
+	GetAbilityDependencyPaths(Spec->Ability->GetClass(), Paths);
+	
+	const int32 ResidentCount = Algo::CountIf(Paths, [](const FSoftObjectPath& Path) { return Path.ResolveObject() != nullptr; });
+	Subsystem->RecordAbilityFirstActivation(Spec->Ability->GetClass(), ResidentCount, Paths.Num());
 }
 
-bool UNinjaGASAbilitySystemComponent::TryBatchActivateAbility(const FGameplayAbilitySpecHandle AbilityHandle, const bool bEndAbilityImmediately)
+void UNinjaGASAbilitySystemComponent::IndexAbilitySpec(const FGameplayAbilitySpec& AbilitySpec)
 {
-	bool bAbilityActivated = false;
-	if (AbilityHandle.IsValid())
+	bAbilitySpecIndicesDirty = true;
+	
+	const FGameplayAbilitySpecHandle& Handle = AbilitySpec.Handle;
+	if (!Handle.IsValid() || !AbilitySpec.Ability)
 	{
-		GAS_LOG(Warning, "Ability handle is invalid!");
-		return bAbilityActivated;
+		return;
 	}
+
+	AbilityHandlesByClass.FindOrAdd(TObjectKey<UClass>(AbilitySpec.Ability->GetClass())).AddUnique(Handle);
+
+	const FGameplayTagContainer IndexedTags = AbilitySpec.Ability->GetAssetTags().GetGameplayTagParents();
+	for (const FGameplayTag& Tag : IndexedTags)
+	{
+		AbilityHandlesByTag.FindOrAdd(Tag).AddUnique(Handle);
+	}
+
+	if (AbilitySpec.InputID != INDEX_NONE)
+	{
+		AbilityHandlesByInputID.FindOrAdd(AbilitySpec.InputID).AddUnique(Handle);
+		IndexedInputIDs.Add(Handle, AbilitySpec.InputID);
+	}
+}
+
+void UNinjaGASAbilitySystemComponent::UnindexAbilitySpec(const FGameplayAbilitySpec& AbilitySpec)
+{
+	bAbilitySpecIndicesDirty = true;
 	
-	FScopedServerAbilityRPCBatcher Batch(this, AbilityHandle);
-	bAbilityActivated = TryActivateAbility(AbilityHandle, true);
+	const FGameplayAbilitySpecHandle& Handle = AbilitySpec.Handle;
+	if (!Handle.IsValid())
+	{
+		return;
+	}
 
-	if (!bEndAbilityImmediately)
+	auto RemoveFromIndex = [&Handle](auto& Index, const auto& Key)
 	{
-		const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(AbilityHandle);
-		if (AbilitySpec != nullptr)
+		if (TArray<FGameplayAbilitySpecHandle>* Handles = Index.Find(Key))
 		{
-			UGameplayAbility* Ability = AbilitySpec->GetPrimaryInstance();
-			if (IsValid(Ability) && Ability->Implements<UBatchGameplayAbilityInterface>())
-			{
-				IBatchGameplayAbilityInterface::Execute_EndAbilityFromBatch(Ability);
-			}
-			else
+			Handles->RemoveSingleSwap(Handle);
+			if (Handles->IsEmpty())
 			{
-				const FString Message = IsValid(Ability) ? FString::Printf(TEXT("%s does not implement Batch Gameplay Ability Interface"), *GetNameSafe(Ability)) : "is invalid"; 
-				GAS_LOG_ARGS(Error, "Ability %s!", *Message);
+				Index.Remove(Key);
 			}
 		}
-	}
+	};
 
-	return bAbilityActivated;
-}
+	if (AbilitySpec.Ability)
+	{
+		RemoveFromIndex(AbilityHandlesByClass, TObjectKey<UClass>(AbilitySpec.Ability->GetClass()));
 
-void UNinjaGASAbilitySystemComponent::CancelAbilitiesByTags(const FGameplayTagContainer AbilityTags, const FGameplayTagContainer CancelFilterTags)
-{
-	CancelAbilities(&AbilityTags, &CancelFilterTags);
-}
+		const FGameplayTagContainer IndexedTags = AbilitySpec.Ability->GetAssetTags().GetGameplayTagParents();
+		for (const FGameplayTag& Tag : IndexedTags)
+		{
+			RemoveFromIndex(AbilityHandlesByTag, Tag);
+		}
+	}
 
-void UNinjaGASAbilitySystemComponent::ExecuteGameplayCueLocal(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const
-{
-	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
-	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::Executed, GameplayCueParameters);
+	int32 IndexedInputID = INDEX_NONE;
+	if (IndexedInputIDs.RemoveAndCopyValue(Handle, IndexedInputID))
+	{
+		RemoveFromIndex(AbilityHandlesByInputID, IndexedInputID);
+	}
 }
 
-void UNinjaGASAbilitySystemComponent::AddGameplayCueLocally(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const
+void UNinjaGASAbilitySystemComponent::RebuildAbilitySpecIndices() const
 {
-	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
-	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::OnActive, GameplayCueParameters);
-	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::WhileActive, GameplayCueParameters);
-}
+	const TArray<FGameplayAbilitySpec>& Specs = ActivatableAbilities.Items;
+	
+	AbilitySpecIndices.Reset();
+	AbilitySpecIndices.Reserve(Specs.Num());
+	
+	for (int32 Index = 0; Index < Specs.Num(); ++Index)
+	{
+		AbilitySpecIndices.Add(Specs[Index].Handle, Index);
+	}
 
-void UNinjaGASAbilitySystemComponent::RemoveGameplayCueLocally(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const
-{
-	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
-	CueManager->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::Removed, GameplayCueParameters);
+	bAbilitySpecIndicesDirty = false;
 }
 
 void UNinjaGASAbilitySystemComponent::ClearActorInfo()
 {
 	ClearDefaults();
+
+	if (UNinjaGASSubsystem* Subsystem = GetNinjaGASSubsystem())
+	{
+		Subsystem->UnregisterAbilitySystemComponent(this);
+	}
+	
 	Super::ClearActorInfo();
 }
 
@@ -339,11 +2047,8 @@ float UNinjaGASAbilitySystemComponent::PlayMontage(UGameplayAbility* AnimatingAb
 			// Replicate to non-owners
 			if (IsOwnerActorAuthoritative())
 			{
-				// Force net update on our avatar actor.
-				if (AbilityActorInfo->AvatarActor != nullptr)
-				{
-					AbilityActorInfo->AvatarActor->ForceNetUpdate();
-				}
+				// Force net update on our avatar actor, which may be coalesced with other montages in this frame.
+				RequestMontageNetUpdate();
 			}
 			else
 			{
@@ -360,10 +2065,61 @@ float UNinjaGASAbilitySystemComponent::PlayMontage(UGameplayAbility* AnimatingAb
 	return Duration;
 }
 
+void UNinjaGASAbilitySystemComponent::RequestMontageNetUpdate()
+{
+	AActor* AvatarActor = AbilityActorInfo.IsValid() ? AbilityActorInfo->AvatarActor.Get() : nullptr;
+	if (AvatarActor == nullptr)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_NinjaGAS_MontageNetUpdatesRequested);
+	
+	UNinjaGASWorldSubsystem* WorldSubsystem = GCoalesceMontageNetUpdates ? GetNinjaGASWorldSubsystem() : nullptr;
+	if (!IsValid(WorldSubsystem))
+	{
+		INC_DWORD_STAT(STAT_NinjaGAS_MontageNetUpdatesForced);
+		AvatarActor->ForceNetUpdate();
+		return;
+	}
+
+	// The replicated montage info is already up to date, so the deferred update carries its final state.
+	if (!bMontageNetUpdatePending)
+	{
+		bMontageNetUpdatePending = true;
+		WorldSubsystem->QueueMontageNetUpdate(this);
+	}
+}
+
+bool UNinjaGASAbilitySystemComponent::FlushMontageNetUpdate()
+{
+	AActor* AvatarActor = AbilityActorInfo.IsValid() ? AbilityActorInfo->AvatarActor.Get() : nullptr;
+	const UWorld* World = GetWorld();
+	
+	if (!bMontageNetUpdatePending || AvatarActor == nullptr || !IsValid(World))
+	{
+		bMontageNetUpdatePending = false;
+		return true;
+	}
+
+	const double CurrentTime = World->GetTimeSeconds();
+	if (CurrentTime - LastMontageNetUpdateTime < GMontageNetUpdateMinInterval)
+	{
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_NinjaGAS_MontageNetUpdatesForced);
+	AvatarActor->ForceNetUpdate();
+	
+	LastMontageNetUpdateTime = CurrentTime;
+	bMontageNetUpdatePending = false;
+	return true;
+}
+
 void UNinjaGASAbilitySystemComponent::SetReplicatedMontageInfo(FGameplayAbilityRepAnimMontage& MutableRepAnimMontageInfo, UAnimMontage* NewMontageToPlay, const FName& StartSectionName)
 {
 	const uint8 PlayInstanceId = MutableRepAnimMontageInfo.PlayInstanceId < UINT8_MAX ? MutableRepAnimMontageInfo.PlayInstanceId + 1 : 0;
-	const uint8 SectionIdToPlay = NewMontageToPlay->GetSectionIndex(StartSectionName) + 1;
+	const uint8 SectionIdToPlay = FNinjaMontageSectionCache::GetSectionIndex(NewMontageToPlay, StartSectionName) + 1;
 	
 #if ENGINE_MINOR_VERSION == 3
 	
@@ -422,6 +2178,10 @@ void UNinjaGASAbilitySystemComponent::ClearDefaults()
 		}	
 	}
 	
+	// Any pending load is no longer relevant.
+	PendingAbilitySetup = nullptr;
+	PendingAbilityDataHandle.Reset();
+	
 	int32 AbilityHandleCount = 0;
 	for (auto It(DefaultAbilityHandles.CreateIterator()); It; ++It)
 	{
@@ -446,6 +2206,9 @@ void UNinjaGASAbilitySystemComponent::ClearDefaults()
 		++AttributeSetCount;
 	}
 
+	DefaultAbilityEntries.Reset();
+	DefaultEffectEntries.Reset();
+	AddedAttributeEntries.Reset();
 	CurrentAbilitySetup = nullptr;
 	
 	UE_LOG(LogAbilitySystemComponent, Log, TEXT("[%s] Cleared Gameplay Elements: [ Attribute Sets: %d, Effects: %d, Abilities: %d, Tags: %d ]."),
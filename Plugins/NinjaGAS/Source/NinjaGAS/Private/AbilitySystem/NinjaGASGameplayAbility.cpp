@@ -4,6 +4,11 @@
 #include "AbilitySystemComponent.h"
 #include "NinjaGASTags.h"
 
+UNinjaGASGameplayAbility::UNinjaGASGameplayAbility()
+{
+	bBatchRPCsOnInput = false;
+}
+
 bool UNinjaGASGameplayAbility::IsPassiveAbility() const
 {
 	return AbilityTags.HasTagExact(Tag_GAS_Ability_Passive);
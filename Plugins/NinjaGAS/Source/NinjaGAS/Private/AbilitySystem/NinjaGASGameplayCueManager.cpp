@@ -0,0 +1,99 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#include "AbilitySystem/NinjaGASGameplayCueManager.h"
+
+#include "GameplayCueNotify_Actor.h"
+#include "NinjaGASWorldSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+AGameplayCueNotify_Actor* UNinjaGASGameplayCueManager::GetInstancedCueActor(AActor* TargetActor, UClass* GameplayCueNotifyActorClass, const FGameplayCueParameters& Parameters)
+{
+	UWorld* World = IsValid(TargetActor) ? TargetActor->GetWorld() : nullptr;
+	UNinjaGASWorldSubsystem* WorldSubsystem = World ? World->GetSubsystem<UNinjaGASWorldSubsystem>() : nullptr;
+	if (!IsValid(WorldSubsystem))
+	{
+		return Super::GetInstancedCueActor(TargetActor, GameplayCueNotifyActorClass, Parameters);
+	}
+
+	const int32 PooledBefore = GetPooledCueNotifyCount(World, GameplayCueNotifyActorClass);
+	AGameplayCueNotify_Actor* CueActor = Super::GetInstancedCueActor(TargetActor, GameplayCueNotifyActorClass, Parameters);
+	if (!IsValid(CueActor))
+	{
+		return CueActor;
+	}
+
+	// Instances already active for the same target are reused by the base class, which is neither a hit nor a miss.
+	const bool bHit = GetPooledCueNotifyCount(World, GameplayCueNotifyActorClass) < PooledBefore;
+	const bool bSpawned = !bHit && CueActor->GetGameTimeSinceCreation() <= 0.f;
+	if (bHit || bSpawned)
+	{
+		WorldSubsystem->RecordCueNotifyRequest(GameplayCueNotifyActorClass, bHit);
+	}
+	
+	return CueActor;
+}
+
+void UNinjaGASGameplayCueManager::NotifyGameplayCueActorFinished(AGameplayCueNotify_Actor* Actor)
+{
+	UWorld* World = IsValid(Actor) ? Actor->GetWorld() : nullptr;
+	UNinjaGASWorldSubsystem* WorldSubsystem = World ? World->GetSubsystem<UNinjaGASWorldSubsystem>() : nullptr;
+	if (!IsValid(WorldSubsystem))
+	{
+		Super::NotifyGameplayCueActorFinished(Actor);
+		return;
+	}
+
+	UClass* NotifyClass = Actor->GetClass();
+	const int32 PooledBefore = GetPooledCueNotifyCount(World, NotifyClass);
+	
+	Super::NotifyGameplayCueActorFinished(Actor);
+
+	// Actors already in the recycle queue are ignored by the base class, so nothing changes.
+	const int32 PooledAfter = GetPooledCueNotifyCount(World, NotifyClass);
+	if (PooledAfter != PooledBefore || !IsValid(Actor))
+	{
+		WorldSubsystem->RecordCueNotifyFinished(NotifyClass, PooledAfter > PooledBefore);
+	}
+}
+
+bool UNinjaGASGameplayCueManager::IsActorRecyclingEnabled()
+{
+	static const IConsoleVariable* RecycleVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("AbilitySystem.GameplayCueActorRecycle"));
+	return RecycleVariable == nullptr || RecycleVariable->GetInt() > 0;
+}
+
+bool UNinjaGASGameplayCueManager::PrewarmCueNotifyActor(UWorld* World, UClass* NotifyClass)
+{
+	if (!IsValid(World) || !IsValid(NotifyClass) || !NotifyClass->IsChildOf<AGameplayCueNotify_Actor>())
+	{
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	
+	AGameplayCueNotify_Actor* Instance = World->SpawnActor<AGameplayCueNotify_Actor>(NotifyClass, SpawnParameters);
+	if (!IsValid(Instance))
+	{
+		return false;
+	}
+
+	// Same state the base class leaves preallocated instances in.
+	Instance->bInRecycleQueue = true;
+	Instance->SetActorHiddenInGame(true);
+	GetPreallocationInfo(World).PreallocatedInstances.FindOrAdd(NotifyClass).Push(Instance);
+	return true;
+}
+
+int32 UNinjaGASGameplayCueManager::GetPooledCueNotifyCount(UWorld* World, UClass* NotifyClass)
+{
+	if (!IsValid(World) || !IsValid(NotifyClass))
+	{
+		return 0;
+	}
+
+	const FPreallocationInfo& PreallocationInfo = GetPreallocationInfo(World);
+	const TArray<TObjectPtr<AGameplayCueNotify_Actor>>* PooledInstances = PreallocationInfo.PreallocatedInstances.Find(NotifyClass);
+	return PooledInstances ? PooledInstances->Num() : 0;
+}
@@ -0,0 +1,59 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#include "AbilitySystem/Types/FNinjaAttributeInitializer.h"
+
+#include "AttributeSet.h"
+#include "Engine/DataTable.h"
+
+void FNinjaAttributeInitializer::Compile(const UClass* InAttributeSetClass, const UDataTable* AttributeTable)
+{
+	check(InAttributeSetClass && AttributeTable);
+	
+	static const FString Context = TEXT("FNinjaAttributeInitializer::Compile");
+
+	AttributeSetClass = InAttributeSetClass;
+	Entries.Reset();
+	
+	for (TFieldIterator<FProperty> It(InAttributeSetClass, EFieldIteratorFlags::IncludeSuper); It; ++It)
+	{
+		const FProperty* Property = *It;
+		const FNumericProperty* NumericProperty = CastField<FNumericProperty>(Property);
+		if (NumericProperty == nullptr && !FGameplayAttribute::IsGameplayAttributeDataProperty(Property))
+		{
+			continue;
+		}
+
+		// Same row naming used by the Attribute Set: "OwnerClass.PropertyName".
+		const FString RowName = FString::Printf(TEXT("%s.%s"), *Property->GetOwnerVariant().GetName(), *Property->GetName());
+		const FAttributeMetaData* MetaData = AttributeTable->FindRow<FAttributeMetaData>(FName(*RowName), Context, false);
+		if (MetaData == nullptr)
+		{
+			continue;
+		}
+
+		FNinjaAttributeInitializerEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.Offset = Property->GetOffset_ForInternal();
+		Entry.NumericProperty = NumericProperty;
+		Entry.Value = MetaData->BaseValue;
+	}
+}
+
+void FNinjaAttributeInitializer::Apply(UAttributeSet* AttributeSet) const
+{
+	check(IsValid(AttributeSet) && AttributeSet->IsA(AttributeSetClass));
+	
+	uint8* Container = reinterpret_cast<uint8*>(AttributeSet);
+	for (const FNinjaAttributeInitializerEntry& Entry : Entries)
+	{
+		void* Data = Container + Entry.Offset;
+		if (Entry.NumericProperty != nullptr)
+		{
+			Entry.NumericProperty->SetFloatingPointPropertyValue(Data, Entry.Value);
+		}
+		else
+		{
+			FGameplayAttributeData* AttributeData = static_cast<FGameplayAttributeData*>(Data);
+			AttributeData->SetBaseValue(Entry.Value);
+			AttributeData->SetCurrentValue(Entry.Value);
+		}
+	}
+}
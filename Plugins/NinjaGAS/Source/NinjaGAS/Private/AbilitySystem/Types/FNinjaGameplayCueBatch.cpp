@@ -0,0 +1,58 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#include "AbilitySystem/Types/FNinjaGameplayCueBatch.h"
+
+namespace NinjaGASCueBatch
+{
+	/** Compares all replicated members from two sets of cue parameters. */
+	bool AreParametersEqual(const FGameplayCueParameters& A, const FGameplayCueParameters& B)
+	{
+		return A.NormalizedMagnitude == B.NormalizedMagnitude
+			&& A.RawMagnitude == B.RawMagnitude
+			&& A.EffectContext == B.EffectContext
+			&& A.MatchedTagName == B.MatchedTagName
+			&& A.OriginalTag == B.OriginalTag
+			&& A.AggregatedSourceTags == B.AggregatedSourceTags
+			&& A.AggregatedTargetTags == B.AggregatedTargetTags
+			&& A.Location == B.Location
+			&& A.Normal == B.Normal
+			&& A.Instigator == B.Instigator
+			&& A.EffectCauser == B.EffectCauser
+			&& A.SourceObject == B.SourceObject
+			&& A.PhysicalMaterial == B.PhysicalMaterial
+			&& A.GameplayEffectLevel == B.GameplayEffectLevel
+			&& A.AbilityLevel == B.AbilityLevel
+			&& A.TargetAttachComponent == B.TargetAttachComponent
+			&& A.bReplicateLocationWhenUsingMinimalRepProxy == B.bReplicateLocationWhenUsingMinimalRepProxy;
+	}
+}
+
+bool FNinjaGameplayCueBatch::Add(const FGameplayTag& GameplayCueTag, const FPredictionKey& PredictionKey, const ENinjaGameplayCueBatchEvent EventType, const FGameplayCueParameters& CueParameters)
+{
+	int32 ParametersIndex = Parameters.IndexOfByPredicate([&CueParameters](const FGameplayCueParameters& Existing)
+	{
+		return NinjaGASCueBatch::AreParametersEqual(Existing, CueParameters);
+	});
+
+	if (ParametersIndex == INDEX_NONE)
+	{
+		if (Parameters.Num() >= MaxParameters)
+		{
+			return false;
+		}
+
+		ParametersIndex = Parameters.Add(CueParameters);
+	}
+
+	FNinjaGameplayCueBatchEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.GameplayCueTag = GameplayCueTag;
+	Entry.PredictionKey = PredictionKey;
+	Entry.EventType = EventType;
+	Entry.ParametersIndex = static_cast<uint8>(ParametersIndex);
+	return true;
+}
+
+void FNinjaGameplayCueBatch::Reset()
+{
+	Entries.Reset();
+	Parameters.Reset();
+}
@@ -0,0 +1,88 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#include "AbilitySystem/Types/FNinjaMontageSectionCache.h"
+
+#include "Animation/AnimMontage.h"
+#include "UObject/ObjectKey.h"
+
+namespace NinjaGASMontageSections
+{
+	/** Section indices by name, for each montage. */
+	TMap<TObjectKey<UAnimMontage>, TMap<FName, int32>> SectionIndices;
+
+#if WITH_EDITOR
+	FDelegateHandle ObjectModifiedHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+}
+
+int32 FNinjaMontageSectionCache::GetSectionIndex(const UAnimMontage* Montage, const FName SectionName)
+{
+	check(IsInGameThread());
+	
+	if (!IsValid(Montage) || SectionName.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	if (Montage->IsDynamicMontage())
+	{
+		return Montage->GetSectionIndex(SectionName);
+	}
+
+	TMap<FName, int32>* Indices = NinjaGASMontageSections::SectionIndices.Find(Montage);
+	if (Indices == nullptr)
+	{
+		Indices = &NinjaGASMontageSections::SectionIndices.Add(Montage);
+		Indices->Reserve(Montage->CompositeSections.Num());
+
+		// Added in order, without replacing, so duplicate names resolve to the first section like the montage does.
+		for (int32 Index = 0; Index < Montage->CompositeSections.Num(); ++Index)
+		{
+			const FName& Name = Montage->CompositeSections[Index].SectionName;
+			if (!Indices->Contains(Name))
+			{
+				Indices->Add(Name, Index);
+			}
+		}
+	}
+
+	const int32* SectionIndex = Indices->Find(SectionName);
+	return SectionIndex ? *SectionIndex : INDEX_NONE;
+}
+
+void FNinjaMontageSectionCache::Invalidate(const UObject* Montage)
+{
+	if (const UAnimMontage* AnimMontage = Cast<UAnimMontage>(Montage))
+	{
+		NinjaGASMontageSections::SectionIndices.Remove(AnimMontage);
+	}
+}
+
+void FNinjaMontageSectionCache::Reset()
+{
+	NinjaGASMontageSections::SectionIndices.Reset();
+}
+
+void FNinjaMontageSectionCache::Initialize()
+{
+#if WITH_EDITOR
+	NinjaGASMontageSections::ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddLambda([](UObject* Object)
+	{
+		Invalidate(Object);
+	});
+	
+	NinjaGASMontageSections::ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda([](UObject* Object, FPropertyChangedEvent&)
+	{
+		Invalidate(Object);
+	});
+#endif
+}
+
+void FNinjaMontageSectionCache::Shutdown()
+{
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectModified.Remove(NinjaGASMontageSections::ObjectModifiedHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(NinjaGASMontageSections::ObjectPropertyChangedHandle);
+#endif
+	Reset();
+}
@@ -2,7 +2,7 @@
 #include "Async/NinjaGASAction_WaitForAbilitySystem.h"
 
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
+#include "NinjaGASFunctionLibrary.h"
 #include "TimerManager.h"
 #include "UnrealEngine.h"
 #include "GameFramework/PlayerState.h"
@@ -48,7 +48,7 @@ void UNinjaGASAction_WaitForAbilitySystem::Activate()
 		return;
 	}
 
-	const UAbilitySystemComponent* AbilityComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(AbilityOwner);
+	const UAbilitySystemComponent* AbilityComponent = UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(AbilityOwner);
 	if (IsValid(AbilityComponent) && !AbilityComponent->GetAvatarActor()->IsA<APlayerState>())
 	{
 		OnCompleted.Broadcast();
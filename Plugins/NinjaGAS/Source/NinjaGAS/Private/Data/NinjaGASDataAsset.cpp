@@ -2,8 +2,10 @@
 #include "Data/NinjaGASDataAsset.h"
 
 #include "GameplayTagContainer.h"
+#include "Engine/AssetManager.h"
 
 FPrimaryAssetType UNinjaGASDataAsset::AssetType = TEXT("AbilityBundleData");
+const FName UNinjaGASDataAsset::AbilitiesBundle = TEXT("Abilities");
 
 UNinjaGASDataAsset::UNinjaGASDataAsset()
 {
@@ -14,3 +16,69 @@ FPrimaryAssetId UNinjaGASDataAsset::GetPrimaryAssetId() const
 {
 	return FPrimaryAssetId(AssetType, GetFName());
 }
+
+void UNinjaGASDataAsset::GetAbilityBundlePaths(TArray<FSoftObjectPath>& OutPaths) const
+{
+	OutPaths.Reserve(OutPaths.Num() + DefaultAttributeSets.Num() * 2 + DefaultGameplayEffects.Num() + DefaultGameplayAbilities.Num());
+	
+	for (const FDefaultAttributeSet& Entry : DefaultAttributeSets)
+	{
+		if (!Entry.AttributeSetClass.IsNull())
+		{
+			OutPaths.AddUnique(Entry.AttributeSetClass.ToSoftObjectPath());
+		}
+		
+		if (!Entry.AttributeTable.IsNull())
+		{
+			OutPaths.AddUnique(Entry.AttributeTable.ToSoftObjectPath());
+		}
+	}
+
+	for (const FDefaultGameplayEffect& Entry : DefaultGameplayEffects)
+	{
+		if (!Entry.GameplayEffectClass.IsNull())
+		{
+			OutPaths.AddUnique(Entry.GameplayEffectClass.ToSoftObjectPath());
+		}
+	}
+
+	for (const FDefaultGameplayAbility& Entry : DefaultGameplayAbilities)
+	{
+		if (!Entry.GameplayAbilityClass.IsNull())
+		{
+			OutPaths.AddUnique(Entry.GameplayAbilityClass.ToSoftObjectPath());
+		}
+	}
+}
+
+bool UNinjaGASDataAsset::IsAbilityBundleLoaded() const
+{
+	TArray<FSoftObjectPath> Paths;
+	GetAbilityBundlePaths(Paths);
+
+	return !Paths.ContainsByPredicate([](const FSoftObjectPath& Path) { return Path.ResolveObject() == nullptr; });
+}
+
+TSharedPtr<FStreamableHandle> UNinjaGASDataAsset::LoadAbilityBundle(const FStreamableDelegate& OnLoaded) const
+{
+	UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+	if (!IsValid(AssetManager))
+	{
+		return nullptr;
+	}
+
+	const FPrimaryAssetId AssetId = GetPrimaryAssetId();
+	if (AssetManager->GetPrimaryAssetPath(AssetId).IsValid())
+	{
+		return AssetManager->LoadPrimaryAsset(AssetId, { AbilitiesBundle }, OnLoaded);
+	}
+
+	TArray<FSoftObjectPath> Paths;
+	GetAbilityBundlePaths(Paths);
+	if (Paths.IsEmpty())
+	{
+		return nullptr;
+	}
+	
+	return AssetManager->GetStreamableManager().RequestAsyncLoad(Paths, OnLoaded);
+}
@@ -4,6 +4,7 @@
 #include "NinjaGASFunctionLibrary.h"
 #include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
 #include "Components/GameFrameworkComponentManager.h"
+#include "Net/UnrealNetwork.h"
 
 FName ANinjaGASActor::AbilitySystemComponentName = TEXT("AbilitySystemComponent");
 
@@ -12,6 +13,8 @@ ANinjaGASActor::ANinjaGASActor(const FObjectInitializer& ObjectInitializer) : Su
 	bReplicates = true;
 	MinNetUpdateFrequency = 11.f;
 	AbilityReplicationMode = EGameplayEffectReplicationMode::Minimal;
+	bEnableLazyAbilitySystem = false;
+	LazyAbilitySystemClass = UNinjaGASAbilitySystemComponent::StaticClass();
 
 	ActorAbilities = CreateOptionalDefaultSubobject<UNinjaGASAbilitySystemComponent>(AbilitySystemComponentName);
 	if (IsValid(ActorAbilities))
@@ -32,6 +35,12 @@ void ANinjaGASActor::PostInitProperties()
 	}		
 }
 
+void ANinjaGASActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	DOREPLIFETIME(ThisClass, ActorAbilities);
+}
+
 void ANinjaGASActor::PreInitializeComponents()
 {
 	Super::PreInitializeComponents();
@@ -48,7 +57,12 @@ void ANinjaGASActor::BeginPlay()
 	// Doing this is useful as it makes this class compatible with both a gameplay feature and the
 	// ASC interface, avoiding the component lookup.
 	//
-	ActorAbilities = UNinjaGASFunctionLibrary::GetCustomAbilitySystemComponentFromActor(this);
+	// In lazy mode, the interface would create the ASC, so only look for existing components.
+	//
+	ActorAbilities = bEnableLazyAbilitySystem
+		? FindComponentByClass<UNinjaGASAbilitySystemComponent>()
+		: UNinjaGASFunctionLibrary::GetCustomAbilitySystemComponentFromActor(this);
+	
 	if (IsValid(ActorAbilities))
 	{
 		ActorAbilities->InitAbilityActorInfo(this, this);
@@ -63,5 +77,45 @@ void ANinjaGASActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 UAbilitySystemComponent* ANinjaGASActor::GetAbilitySystemComponent() const
 {
+	if (!IsValid(ActorAbilities) && bEnableLazyAbilitySystem && HasAuthority()
+		&& (HasActorBegunPlay() || IsActorBeginningPlay()) && !IsActorBeingDestroyed())
+	{
+		// First time the ASC is needed. Clients will receive it via replication.
+		return const_cast<ThisClass*>(this)->CreateLazyAbilitySystemComponent();
+	}
+	
 	return ActorAbilities;
 }
+
+bool ANinjaGASActor::HasAbilitySystemComponent() const
+{
+	return IsValid(ActorAbilities);
+}
+
+UNinjaGASAbilitySystemComponent* ANinjaGASActor::CreateLazyAbilitySystemComponent()
+{
+	check(HasAuthority());
+	
+	const TSubclassOf<UNinjaGASAbilitySystemComponent> AbilitySystemClass = IsValid(LazyAbilitySystemClass)
+		? LazyAbilitySystemClass : TSubclassOf<UNinjaGASAbilitySystemComponent>(UNinjaGASAbilitySystemComponent::StaticClass());
+	
+	ActorAbilities = NewObject<UNinjaGASAbilitySystemComponent>(this, AbilitySystemClass, AbilitySystemComponentName);
+	ActorAbilities->SetIsReplicated(bReplicates);
+	ActorAbilities->SetReplicationMode(AbilityReplicationMode);
+	ActorAbilities->RegisterComponent();
+	AddInstanceComponent(ActorAbilities);
+	
+	ActorAbilities->InitAbilityActorInfo(this, this);
+	ForceNetUpdate();
+
+	UE_LOG(LogAbilitySystemComponent, Verbose, TEXT("[%s] Created lazy Ability System Component."), *GetNameSafe(this));
+	return ActorAbilities;
+}
+
+void ANinjaGASActor::OnRep_ActorAbilities()
+{
+	if (IsValid(ActorAbilities))
+	{
+		ActorAbilities->InitAbilityActorInfo(this, this);
+	}
+}
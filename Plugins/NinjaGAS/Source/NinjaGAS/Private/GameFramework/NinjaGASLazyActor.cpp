@@ -0,0 +1,8 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#include "GameFramework/NinjaGASLazyActor.h"
+
+ANinjaGASLazyActor::ANinjaGASLazyActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.DoNotCreateDefaultSubobject(AbilitySystemComponentName))
+{
+	bEnableLazyAbilitySystem = true;
+}
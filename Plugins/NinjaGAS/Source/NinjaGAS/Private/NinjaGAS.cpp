@@ -2,14 +2,18 @@
 
 #include "NinjaGAS.h"
 
+#include "AbilitySystem/Types/FNinjaMontageSectionCache.h"
+
 #define LOCTEXT_NAMESPACE "FNinjaGASModule"
 
 void FNinjaGASModule::StartupModule()
 {
+	FNinjaMontageSectionCache::Initialize();
 }
 
 void FNinjaGASModule::ShutdownModule()
 {
+	FNinjaMontageSectionCache::Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -3,17 +3,101 @@
 
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
+#include "NinjaGASLog.h"
+#include "NinjaGASSubsystem.h"
 #include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
+#include "Engine/GameInstance.h"
+
+namespace NinjaGASRegistry
+{
+	/**
+	 * Provides the subsystem holding the registered components for the actor's game instance.
+	 */
+	const UNinjaGASSubsystem* GetSubsystem(const AActor* Actor)
+	{
+		const UGameInstance* GameInstance = IsValid(Actor) ? Actor->GetGameInstance() : nullptr;
+		return UGameInstance::GetSubsystem<UNinjaGASSubsystem>(GameInstance);
+	}
+
+	/**
+	 * Finds the registered component, falling back to the interface and component search.
+	 */
+	UAbilitySystemComponent* FindAbilitySystemComponent(const UNinjaGASSubsystem* Subsystem, const AActor* Actor)
+	{
+		if (IsValid(Subsystem))
+		{
+			if (UNinjaGASAbilitySystemComponent* AbilityComponent = Subsystem->FindAbilitySystemComponent(Actor))
+			{
+				return AbilityComponent;
+			}
+		}
+
+		return UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor);
+	}
+}
 
 UNinjaGASAbilitySystemComponent* UNinjaGASFunctionLibrary::GetCustomAbilitySystemComponentFromActor(AActor* Owner)
 {
-	UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Owner);
+	UAbilitySystemComponent* ASC = GetAbilitySystemComponentFromActor(Owner);
 	return Cast<UNinjaGASAbilitySystemComponent>(ASC);	
 }
 
+UAbilitySystemComponent* UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(const AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return nullptr;
+	}
+	
+	return NinjaGASRegistry::FindAbilitySystemComponent(NinjaGASRegistry::GetSubsystem(Actor), Actor);
+}
+
+void UNinjaGASFunctionLibrary::GetAbilitySystemComponentsFromActors(const TArray<AActor*>& Actors, TArray<UAbilitySystemComponent*>& OutComponents)
+{
+	OutComponents.Reset(Actors.Num());
+
+	// All actors are expected to share a game instance, so the subsystem is resolved once.
+	const UNinjaGASSubsystem* Subsystem = nullptr;
+	for (const AActor* Actor : Actors)
+	{
+		if (!IsValid(Actor))
+		{
+			OutComponents.Add(nullptr);
+			continue;
+		}
+
+		if (Subsystem == nullptr)
+		{
+			Subsystem = NinjaGASRegistry::GetSubsystem(Actor);
+		}
+		
+		OutComponents.Add(NinjaGASRegistry::FindAbilitySystemComponent(Subsystem, Actor));
+	}
+}
+
+FNinjaEffectBatchResult UNinjaGASFunctionLibrary::ApplyGameplayEffectSpecToTargets(const FGameplayEffectSpecHandle& SpecHandle,
+	const TArray<AActor*>& Targets, TArray<FActiveGameplayEffectHandle>& OutHandles)
+{
+	OutHandles.Reset();
+	if (!SpecHandle.IsValid())
+	{
+		return FNinjaEffectBatchResult();
+	}
+
+	const FGameplayEffectSpec& Spec = *SpecHandle.Data.Get();
+	UNinjaGASAbilitySystemComponent* SourceComponent = Cast<UNinjaGASAbilitySystemComponent>(Spec.GetContext().GetInstigatorAbilitySystemComponent());
+	if (!IsValid(SourceComponent))
+	{
+		UE_LOG(LogNinjaGAS, Warning, TEXT("Effect batch for %s requires a spec created by a Ninja GAS Ability System Component."), *GetNameSafe(Spec.Def));
+		return FNinjaEffectBatchResult();
+	}
+
+	return SourceComponent->ApplyGameplayEffectSpecToTargets(Spec, Targets, OutHandles);
+}
+
 int32 UNinjaGASFunctionLibrary::SendGameplayEventToActor(const AActor* AbilityOwner, const FGameplayTag EventTag, const FGameplayEventData& EventData)
 {
-	UAbilitySystemComponent* AbilityComponent = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(AbilityOwner);
+	UAbilitySystemComponent* AbilityComponent = GetAbilitySystemComponentFromActor(AbilityOwner);
 	return SendGameplayEventToComponent(AbilityComponent, EventTag, EventData);
 }
 
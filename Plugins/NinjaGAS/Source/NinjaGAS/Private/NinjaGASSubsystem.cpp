@@ -2,9 +2,328 @@
 #include "NinjaGASSubsystem.h"
 
 #include "AbilitySystemGlobals.h"
+#include "GameplayCueManager.h"
+#include "GameplayCueSet.h"
+#include "GameplayEffect.h"
+#include "NinjaGASLog.h"
+#include "Abilities/GameplayAbility.h"
+#include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
+#include "Data/NinjaGASDataAsset.h"
+#include "Engine/DataTable.h"
+#include "Engine/StreamableManager.h"
+
+namespace NinjaGASDependencies
+{
+	/**
+	 * Collects soft references and cue tags from a property value, recursing into structs and arrays.
+	 */
+	void CollectFromProperty(const FProperty* Property, const void* Value, TSet<FSoftObjectPath>& OutPaths, FGameplayTagContainer& OutCueTags);
+	
+	/**
+	 * Collects soft references and cue tags from all properties in a struct or class.
+	 */
+	void CollectFromStruct(const UStruct* Struct, const void* Container, TSet<FSoftObjectPath>& OutPaths, FGameplayTagContainer& OutCueTags)
+	{
+		for (TFieldIterator<FProperty> It(Struct, EFieldIteratorFlags::IncludeSuper); It; ++It)
+		{
+			const FProperty* Property = *It;
+			for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+			{
+				CollectFromProperty(Property, Property->ContainerPtrToValuePtr<void>(Container, Index), OutPaths, OutCueTags);
+			}
+		}
+	}
+
+	/**
+	 * Collects cue tags from a loaded Gameplay Effect class.
+	 */
+	void CollectFromEffect(const UClass* EffectClass, FGameplayTagContainer& OutCueTags)
+	{
+		const UGameplayEffect* Effect = EffectClass ? Cast<UGameplayEffect>(EffectClass->GetDefaultObject()) : nullptr;
+		if (IsValid(Effect))
+		{
+			for (const FGameplayEffectCue& Cue : Effect->GameplayCues)
+			{
+				OutCueTags.AppendTags(Cue.GameplayCueTags);
+			}
+		}
+	}
+
+	void CollectFromProperty(const FProperty* Property, const void* Value, TSet<FSoftObjectPath>& OutPaths, FGameplayTagContainer& OutCueTags)
+	{
+		static const FGameplayTag CueRootTag = FGameplayTag::RequestGameplayTag(TEXT("GameplayCue"), false);
+		
+		if (const FSoftObjectProperty* SoftProperty = CastField<FSoftObjectProperty>(Property))
+		{
+			const FSoftObjectPtr& SoftObject = *static_cast<const FSoftObjectPtr*>(Value);
+			if (!SoftObject.IsNull())
+			{
+				OutPaths.Add(SoftObject.ToSoftObjectPath());
+				if (const FSoftClassProperty* SoftClassProperty = CastField<FSoftClassProperty>(SoftProperty))
+				{
+					if (SoftClassProperty->MetaClass && SoftClassProperty->MetaClass->IsChildOf(UGameplayEffect::StaticClass()))
+					{
+						// Only resolved effects can be inspected for cues. Others are loaded with the ability.
+						CollectFromEffect(Cast<UClass>(SoftObject.Get()), OutCueTags);
+					}
+				}
+			}
+		}
+		else if (const FClassProperty* ClassProperty = CastField<FClassProperty>(Property))
+		{
+			if (ClassProperty->MetaClass && ClassProperty->MetaClass->IsChildOf(UGameplayEffect::StaticClass()))
+			{
+				CollectFromEffect(Cast<UClass>(ClassProperty->GetObjectPropertyValue(Value)), OutCueTags);
+			}
+		}
+		else if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			if (StructProperty->Struct == FGameplayTag::StaticStruct())
+			{
+				const FGameplayTag& Tag = *static_cast<const FGameplayTag*>(Value);
+				if (CueRootTag.IsValid() && Tag.MatchesTag(CueRootTag))
+				{
+					OutCueTags.AddTag(Tag);
+				}
+			}
+			else if (StructProperty->Struct == FGameplayTagContainer::StaticStruct())
+			{
+				const FGameplayTagContainer& Tags = *static_cast<const FGameplayTagContainer*>(Value);
+				if (CueRootTag.IsValid())
+				{
+					OutCueTags.AppendTags(Tags.Filter(FGameplayTagContainer(CueRootTag)));
+				}
+			}
+			else
+			{
+				CollectFromStruct(StructProperty->Struct, Value, OutPaths, OutCueTags);
+			}
+		}
+		else if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+		{
+			FScriptArrayHelper Helper(ArrayProperty, Value);
+			for (int32 Index = 0; Index < Helper.Num(); ++Index)
+			{
+				CollectFromProperty(ArrayProperty->Inner, Helper.GetRawPtr(Index), OutPaths, OutCueTags);
+			}
+		}
+	}
+}
 
 void UNinjaGASSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 	UAbilitySystemGlobals::Get().InitGlobalData();
 }
+
+void UNinjaGASSubsystem::Deinitialize()
+{
+#if WITH_EDITOR
+	for (const TWeakObjectPtr<UDataTable>& AttributeTable : ObservedAttributeTables)
+	{
+		if (AttributeTable.IsValid())
+		{
+			AttributeTable->OnDataTableChanged().RemoveAll(this);
+		}
+	}
+	ObservedAttributeTables.Reset();
+#endif
+
+	for (const TPair<TObjectKey<UNinjaGASDataAsset>, TSharedPtr<FStreamableHandle>>& Entry : PreloadedAbilityData)
+	{
+		if (Entry.Value.IsValid())
+		{
+			Entry.Value->ReleaseHandle();
+		}
+	}
+	
+	PreloadedAbilityData.Reset();
+	AttributeInitializers.Reset();
+	AbilitySystemComponents.Reset();
+	AbilitySystemComponentActors.Reset();
+	Super::Deinitialize();
+}
+
+TSharedRef<const FNinjaAttributeInitializer> UNinjaGASSubsystem::GetAttributeInitializer(const UClass* AttributeSetClass, const UDataTable* AttributeTable)
+{
+	check(IsValid(AttributeSetClass) && IsValid(AttributeTable));
+	
+	const FAttributeInitializerKey Key(AttributeSetClass, AttributeTable);
+	if (const TSharedRef<const FNinjaAttributeInitializer>* Initializer = AttributeInitializers.Find(Key))
+	{
+		return *Initializer;
+	}
+
+	const TSharedRef<FNinjaAttributeInitializer> NewInitializer = MakeShared<FNinjaAttributeInitializer>();
+	NewInitializer->Compile(AttributeSetClass, AttributeTable);
+	AttributeInitializers.Add(Key, NewInitializer);
+
+#if WITH_EDITOR
+	UDataTable* MutableAttributeTable = const_cast<UDataTable*>(AttributeTable);
+	if (!ObservedAttributeTables.Contains(MutableAttributeTable))
+	{
+		ObservedAttributeTables.Add(MutableAttributeTable);
+		MutableAttributeTable->OnDataTableChanged().AddUObject(this, &ThisClass::HandleAttributeTableChanged, TWeakObjectPtr<UDataTable>(MutableAttributeTable));
+	}
+#endif
+	
+	UE_LOG(LogNinjaGAS, Verbose, TEXT("Compiled attribute initializer for %s from %s with %d values."),
+		*GetNameSafe(AttributeSetClass), *GetNameSafe(AttributeTable), NewInitializer->Entries.Num());
+	
+	return NewInitializer;
+}
+
+void UNinjaGASSubsystem::InvalidateAttributeInitializers(const UDataTable* AttributeTable)
+{
+	const TObjectKey<UDataTable> TableKey(AttributeTable);
+	for (auto It(AttributeInitializers.CreateIterator()); It; ++It)
+	{
+		if (It.Key().Value == TableKey)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UNinjaGASSubsystem::PreloadAbilityData(const TArray<UNinjaGASDataAsset*>& AbilityData)
+{
+	for (const UNinjaGASDataAsset* Entry : AbilityData)
+	{
+		if (!IsValid(Entry) || PreloadedAbilityData.Contains(Entry))
+		{
+			continue;
+		}
+
+		const TSharedPtr<FStreamableHandle> Handle = Entry->LoadAbilityBundle();
+		PreloadedAbilityData.Add(Entry, Handle);
+		
+		UE_LOG(LogNinjaGAS, Verbose, TEXT("Preloading ability bundle from %s."), *GetNameSafe(Entry));
+	}
+}
+
+void UNinjaGASSubsystem::ReleasePreloadedAbilityData(const TArray<UNinjaGASDataAsset*>& AbilityData)
+{
+	for (const UNinjaGASDataAsset* Entry : AbilityData)
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		if (PreloadedAbilityData.RemoveAndCopyValue(Entry, Handle) && Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+}
+
+const FNinjaAbilityDependencies& UNinjaGASSubsystem::GetAbilityDependencies(const UClass* AbilityClass)
+{
+	check(IsValid(AbilityClass));
+
+	const TObjectKey<UClass> Key(AbilityClass);
+	if (const FNinjaAbilityDependencies* Dependencies = AbilityDependencies.Find(Key))
+	{
+		return *Dependencies;
+	}
+
+	TSet<FSoftObjectPath> AssetPaths;
+	FGameplayTagContainer CueTags;
+	NinjaGASDependencies::CollectFromStruct(AbilityClass, AbilityClass->GetDefaultObject(), AssetPaths, CueTags);
+
+	FNinjaAbilityDependencies& NewDependencies = AbilityDependencies.Add(Key);
+	NewDependencies.AssetPaths = AssetPaths.Array();
+
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	const UGameplayCueSet* CueSet = IsValid(CueManager) ? CueManager->GetRuntimeCueSet() : nullptr;
+	if (IsValid(CueSet))
+	{
+		for (const FGameplayTag& CueTag : CueTags)
+		{
+			const int32* DataIndex = CueSet->GameplayCueDataMap.Find(CueTag);
+			if (DataIndex != nullptr && CueSet->GameplayCueData.IsValidIndex(*DataIndex))
+			{
+				const FSoftObjectPath& CuePath = CueSet->GameplayCueData[*DataIndex].GameplayCueNotifyObj;
+				if (CuePath.IsValid())
+				{
+					NewDependencies.CuePaths.AddUnique(CuePath);
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogNinjaGAS, Verbose, TEXT("Collected dependencies for %s: [ Assets: %d, Cues: %d ]."),
+		*GetNameSafe(AbilityClass), NewDependencies.AssetPaths.Num(), NewDependencies.CuePaths.Num());
+	
+	return NewDependencies;
+}
+
+void UNinjaGASSubsystem::RecordAbilityFirstActivation(const UClass* AbilityClass, const int32 ResidentCount, const int32 TotalCount)
+{
+	++AbilityPreloadStats.FirstActivations;
+	AbilityPreloadStats.ResidentDependencies += ResidentCount;
+	AbilityPreloadStats.TotalDependencies += TotalCount;
+
+	UE_LOG(LogNinjaGAS, Verbose, TEXT("First activation for %s with %d of %d dependencies resident."),
+		*GetNameSafe(AbilityClass), ResidentCount, TotalCount);
+}
+
+FNinjaAbilityPreloadStats UNinjaGASSubsystem::GetAbilityPreloadStats() const
+{
+	return AbilityPreloadStats;
+}
+
+void UNinjaGASSubsystem::RegisterAbilitySystemComponent(UNinjaGASAbilitySystemComponent* AbilityComponent,
+	const AActor* OwnerActor, const AActor* AvatarActor)
+{
+	check(IsValid(AbilityComponent));
+	UnregisterAbilitySystemComponent(AbilityComponent);
+
+	TArray<TObjectKey<AActor>, TInlineAllocator<2>>& Actors = AbilitySystemComponentActors.Add(AbilityComponent);
+	for (const AActor* Actor : { OwnerActor, AvatarActor })
+	{
+		const TObjectKey<AActor> ActorKey(Actor);
+		if (IsValid(Actor) && !Actors.Contains(ActorKey))
+		{
+			AbilitySystemComponents.Add(ActorKey, AbilityComponent);
+			Actors.Add(ActorKey);
+		}
+	}
+}
+
+void UNinjaGASSubsystem::UnregisterAbilitySystemComponent(const UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	TArray<TObjectKey<AActor>, TInlineAllocator<2>> Actors;
+	if (!AbilitySystemComponentActors.RemoveAndCopyValue(AbilityComponent, Actors))
+	{
+		return;
+	}
+
+	for (const TObjectKey<AActor>& Actor : Actors)
+	{
+		// The actor may have been registered by another component since then.
+		const TWeakObjectPtr<UNinjaGASAbilitySystemComponent>* Registered = AbilitySystemComponents.Find(Actor);
+		if (Registered != nullptr && (!Registered->IsValid() || Registered->Get() == AbilityComponent))
+		{
+			AbilitySystemComponents.Remove(Actor);
+		}
+	}
+}
+
+UNinjaGASAbilitySystemComponent* UNinjaGASSubsystem::FindAbilitySystemComponent(const AActor* Actor) const
+{
+	const TWeakObjectPtr<UNinjaGASAbilitySystemComponent>* Registered = AbilitySystemComponents.Find(Actor);
+	return Registered != nullptr ? Registered->Get() : nullptr;
+}
+
+void UNinjaGASSubsystem::FindAbilitySystemComponents(const TArray<AActor*>& Actors, TArray<UNinjaGASAbilitySystemComponent*>& OutComponents) const
+{
+	OutComponents.Reset(Actors.Num());
+	for (const AActor* Actor : Actors)
+	{
+		OutComponents.Add(FindAbilitySystemComponent(Actor));
+	}
+}
+
+#if WITH_EDITOR
+void UNinjaGASSubsystem::HandleAttributeTableChanged(const TWeakObjectPtr<UDataTable> AttributeTable)
+{
+	InvalidateAttributeInitializers(AttributeTable.Get());
+}
+#endif
@@ -0,0 +1,671 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#include "NinjaGASWorldSubsystem.h"
+
+#include "AbilitySystemGlobals.h"
+#include "GameplayCueManager.h"
+#include "GameplayCueNotify_Actor.h"
+#include "NinjaGASLog.h"
+#include "NinjaGASStats.h"
+#include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
+#include "AbilitySystem/NinjaGASGameplayCueManager.h"
+#include "Data/NinjaGASDataAsset.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Central Ability System Tick"), STAT_NinjaGAS_CentralTick, STATGROUP_NinjaGAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Registered Ability Systems"), STAT_NinjaGAS_RegisteredAbilitySystems, STATGROUP_NinjaGAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ticked Ability Systems"), STAT_NinjaGAS_TickedAbilitySystems, STATGROUP_NinjaGAS);
+DECLARE_CYCLE_STAT(TEXT("Local Gameplay Cues Flush"), STAT_NinjaGAS_LocalCuesFlush, STATGROUP_NinjaGAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Local Gameplay Cues Handled"), STAT_NinjaGAS_LocalCuesHandled, STATGROUP_NinjaGAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Local Gameplay Cues Merged"), STAT_NinjaGAS_LocalCuesMerged, STATGROUP_NinjaGAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Local Gameplay Cues Deferred"), STAT_NinjaGAS_LocalCuesDeferred, STATGROUP_NinjaGAS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cue Notify Pool Hits"), STAT_NinjaGAS_CuePoolHits, STATGROUP_NinjaGAS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cue Notify Pool Misses"), STAT_NinjaGAS_CuePoolMisses, STATGROUP_NinjaGAS);
+
+/**
+ * CVAR to control how often distance-driven tick intervals are evaluated.
+ * Example: ninjagas.CentralTick.SignificanceRefresh 0.5
+ */
+static float GCentralTickSignificanceRefresh = 0.25f;
+static FAutoConsoleVariableRef CVarCentralTickSignificanceRefresh(
+	TEXT("ninjagas.CentralTick.SignificanceRefresh"),
+	GCentralTickSignificanceRefresh,
+	TEXT("Seconds between evaluations of distance-driven tick intervals, for centrally ticked Ability System Components."),
+	ECVF_Default
+);
+
+/**
+ * CVAR to control how many local gameplay cues are handled per frame.
+ * Example: ninjagas.LocalCues.MaxPerFrame 32
+ */
+static int32 GLocalGameplayCuesMaxPerFrame = 16;
+static FAutoConsoleVariableRef CVarLocalGameplayCuesMaxPerFrame(
+	TEXT("ninjagas.LocalCues.MaxPerFrame"),
+	GLocalGameplayCuesMaxPerFrame,
+	TEXT("Maximum local gameplay cues handled per frame. The remainder is handled in the next frames. Zero or less is unlimited."),
+	ECVF_Default
+);
+
+/**
+ * CVAR to control how many cue notify actors are spawned per frame, when prewarming pools.
+ * Example: ninjagas.CuePool.PrewarmPerFrame 8
+ */
+static int32 GCueNotifyPoolPrewarmPerFrame = 4;
+static FAutoConsoleVariableRef CVarCueNotifyPoolPrewarmPerFrame(
+	TEXT("ninjagas.CuePool.PrewarmPerFrame"),
+	GCueNotifyPoolPrewarmPerFrame,
+	TEXT("Maximum cue notify actors spawned per frame, when prewarming pools."),
+	ECVF_Default
+);
+
+UNinjaGASWorldSubsystem::UNinjaGASWorldSubsystem()
+{
+	SignificanceRefreshCountdown = 0.f;
+	bTickingAbilitySystems = false;
+	bHasPendingTickEntryRemovals = false;
+}
+
+void UNinjaGASWorldSubsystem::Deinitialize()
+{
+	TickEntries.Reset();
+	TickEntryIndices.Reset();
+	HibernationCandidates.Reset();
+	QueuedGameplayCues.Reset();
+	QueuedGameplayCueIndices.Reset();
+	PendingGameplayCueBatches.Reset();
+	PendingAbilityRPCBatches.Reset();
+	PendingMontageNetUpdates.Reset();
+	CueNotifyPoolSizes.Reset();
+	PendingCueNotifyPools.Reset();
+	CueNotifyPoolHandles.Reset();
+	CueNotifyPoolStats.Reset();
+	ViewerLocations.Reset();
+	Super::Deinitialize();
+}
+
+bool UNinjaGASWorldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNinjaGASWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNinjaGASWorldSubsystem, STATGROUP_Tickables);
+}
+
+void UNinjaGASWorldSubsystem::Tick(const float DeltaTime)
+{
+	TickAbilitySystems(DeltaTime);
+	FlushAbilityRPCBatches();
+	FlushGameplayCueBatches();
+	FlushMontageNetUpdates();
+	FlushLocalGameplayCues();
+	PrewarmPendingCueNotifyPools();
+}
+
+void UNinjaGASWorldSubsystem::TickAbilitySystems(const float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_NinjaGAS_CentralTick);
+	const double StartTime = FPlatformTime::Seconds();
+
+	SignificanceRefreshCountdown -= DeltaTime;
+	const bool bRefreshIntervals = SignificanceRefreshCountdown <= 0.f;
+	if (bRefreshIntervals)
+	{
+		SignificanceRefreshCountdown = FMath::Max(GCentralTickSignificanceRefresh, 0.f);
+		RefreshViewerLocations();
+		RefreshHibernation();
+	}
+
+	// Components may unregister while ticking, so removals are only applied once all entries are ticked.
+	// Components registered while ticking are added after the last entry and wait for the next frame.
+	bTickingAbilitySystems = true;
+	
+	int32 TickedComponents = 0;
+	const int32 EntryCount = TickEntries.Num();
+	for (int32 Index = 0; Index < EntryCount; ++Index)
+	{
+		FTickEntry& Entry = TickEntries[Index];
+		if (Entry.bPendingRemoval)
+		{
+			continue;
+		}
+		
+		UNinjaGASAbilitySystemComponent* AbilityComponent = Entry.AbilityComponent.Get();
+		if (!IsValid(AbilityComponent))
+		{
+			RemoveTickEntryAt(Index);
+			continue;
+		}
+
+		if (bRefreshIntervals && !Entry.bExplicitInterval)
+		{
+			RefreshTickInterval(Entry);
+		}
+
+		Entry.AccumulatedTime += DeltaTime;
+		if (Entry.AccumulatedTime < Entry.TickInterval)
+		{
+			continue;
+		}
+
+		const float AccumulatedTime = Entry.AccumulatedTime;
+		Entry.AccumulatedTime = 0.f;
+		
+		if (AbilityComponent->ShouldTickCentrally())
+		{
+			AbilityComponent->TickCentrally(AccumulatedTime);
+			++TickedComponents;
+		}
+	}
+
+	bTickingAbilitySystems = false;
+	if (bHasPendingTickEntryRemovals)
+	{
+		CompactTickEntries();
+	}
+
+	const float TickTimeMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	CentralTickStats.RegisteredComponents = TickEntries.Num();
+	CentralTickStats.TickedComponents = TickedComponents;
+	CentralTickStats.TickTimeMs = TickTimeMs;
+	CentralTickStats.PeakTickTimeMs = FMath::Max(CentralTickStats.PeakTickTimeMs, TickTimeMs);
+	
+	SET_DWORD_STAT(STAT_NinjaGAS_RegisteredAbilitySystems, TickEntries.Num());
+	SET_DWORD_STAT(STAT_NinjaGAS_TickedAbilitySystems, TickedComponents);
+}
+
+void UNinjaGASWorldSubsystem::QueueLocalGameplayCue(AActor* Target, const FGameplayTag GameplayCueTag, const EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters)
+{
+	if (!IsValid(Target) || !GameplayCueTag.IsValid())
+	{
+		return;
+	}
+
+	const bool bExecuted = EventType == EGameplayCueEvent::Executed;
+	const FQueuedGameplayCueKey Key(Target, GameplayCueTag, bExecuted);
+	
+	if (const int32* ExistingIndex = QueuedGameplayCueIndices.Find(Key))
+	{
+		FQueuedGameplayCue& Existing = QueuedGameplayCues[*ExistingIndex];
+		if (!bExecuted && Existing.EventType != EventType)
+		{
+			// An add and a remove in the same frame leave the cue as it was.
+			Existing.bCancelled = true;
+			QueuedGameplayCueIndices.Remove(Key);
+		}
+
+		INC_DWORD_STAT(STAT_NinjaGAS_LocalCuesMerged);
+		return;
+	}
+
+	FQueuedGameplayCue& QueuedCue = QueuedGameplayCues.AddDefaulted_GetRef();
+	QueuedCue.Target = Target;
+	QueuedCue.GameplayCueTag = GameplayCueTag;
+	QueuedCue.EventType = EventType;
+	QueuedCue.Parameters = Parameters;
+	
+	QueuedGameplayCueIndices.Add(Key, QueuedGameplayCues.Num() - 1);
+}
+
+void UNinjaGASWorldSubsystem::QueueGameplayCueBatch(UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	if (IsValid(AbilityComponent))
+	{
+		PendingGameplayCueBatches.Add(AbilityComponent);
+	}
+}
+
+void UNinjaGASWorldSubsystem::FlushGameplayCueBatches()
+{
+	if (PendingGameplayCueBatches.IsEmpty())
+	{
+		return;
+	}
+
+	// Swapped out, so components queueing again while flushing are handled in the next frame.
+	TArray<TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> Batches = MoveTemp(PendingGameplayCueBatches);
+	for (const TWeakObjectPtr<UNinjaGASAbilitySystemComponent>& WeakComponent : Batches)
+	{
+		if (UNinjaGASAbilitySystemComponent* AbilityComponent = WeakComponent.Get())
+		{
+			AbilityComponent->FlushGameplayCueBatch();
+		}
+	}
+}
+
+void UNinjaGASWorldSubsystem::QueueAbilityRPCBatch(UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	if (IsValid(AbilityComponent))
+	{
+		PendingAbilityRPCBatches.Add(AbilityComponent);
+	}
+}
+
+void UNinjaGASWorldSubsystem::FlushAbilityRPCBatches()
+{
+	if (PendingAbilityRPCBatches.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> Batches = MoveTemp(PendingAbilityRPCBatches);
+	for (const TWeakObjectPtr<UNinjaGASAbilitySystemComponent>& WeakComponent : Batches)
+	{
+		if (UNinjaGASAbilitySystemComponent* AbilityComponent = WeakComponent.Get())
+		{
+			AbilityComponent->FlushFrameAbilityRPCBatch();
+		}
+	}
+}
+
+void UNinjaGASWorldSubsystem::QueueMontageNetUpdate(UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	if (IsValid(AbilityComponent))
+	{
+		PendingMontageNetUpdates.Add(AbilityComponent);
+	}
+}
+
+void UNinjaGASWorldSubsystem::FlushMontageNetUpdates()
+{
+	for (int32 Index = PendingMontageNetUpdates.Num() - 1; Index >= 0; --Index)
+	{
+		UNinjaGASAbilitySystemComponent* AbilityComponent = PendingMontageNetUpdates[Index].Get();
+		if (!IsValid(AbilityComponent) || AbilityComponent->FlushMontageNetUpdate())
+		{
+			PendingMontageNetUpdates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void UNinjaGASWorldSubsystem::PrewarmCueNotifyPools(const UNinjaGASDataAsset* AbilityData)
+{
+	const UWorld* World = GetWorld();
+	if (!IsValid(AbilityData) || AbilityData->CueNotifyPools.IsEmpty() || !IsValid(World) || World->GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	if (!Cast<UNinjaGASGameplayCueManager>(UAbilitySystemGlobals::Get().GetGameplayCueManager()))
+	{
+		UE_LOG(LogNinjaGAS, Warning, TEXT("Cue notify pools from %s require the Gameplay Cue Manager to be a UNinjaGASGameplayCueManager."), *GetNameSafe(AbilityData));
+		return;
+	}
+
+	if (!UNinjaGASGameplayCueManager::IsActorRecyclingEnabled())
+	{
+		UE_LOG(LogNinjaGAS, Warning, TEXT("Cue notify pools from %s require AbilitySystem.GameplayCueActorRecycle to be enabled."), *GetNameSafe(AbilityData));
+		return;
+	}
+	
+	TArray<FSoftObjectPath> PendingPaths;
+	for (const FNinjaCueNotifyPool& CueNotifyPool : AbilityData->CueNotifyPools)
+	{
+		if (!CueNotifyPool.NotifyClass.IsNull() && CueNotifyPool.NotifyClass.Get() == nullptr)
+		{
+			PendingPaths.AddUnique(CueNotifyPool.NotifyClass.ToSoftObjectPath());
+		}
+	}
+
+	if (PendingPaths.IsEmpty())
+	{
+		AddCueNotifyPools(AbilityData->CueNotifyPools);
+		return;
+	}
+
+	const TWeakObjectPtr<const UNinjaGASDataAsset> WeakAbilityData = AbilityData;
+	const FStreamableDelegate OnLoaded = FStreamableDelegate::CreateWeakLambda(this, [this, WeakAbilityData]()
+	{
+		if (const UNinjaGASDataAsset* LoadedAbilityData = WeakAbilityData.Get())
+		{
+			AddCueNotifyPools(LoadedAbilityData->CueNotifyPools);
+		}
+	});
+
+	FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+	CueNotifyPoolHandles.Add(StreamableManager.RequestAsyncLoad(PendingPaths, OnLoaded));
+}
+
+bool UNinjaGASWorldSubsystem::IsCueNotifyClassPooled(const UClass* NotifyClass) const
+{
+	return CueNotifyPoolSizes.Contains(NotifyClass);
+}
+
+void UNinjaGASWorldSubsystem::RecordCueNotifyRequest(const UClass* NotifyClass, const bool bHit)
+{
+	FNinjaCueNotifyPoolStats& Stats = CueNotifyPoolStats.FindOrAdd(NotifyClass);
+	if (bHit)
+	{
+		++Stats.Hits;
+		INC_DWORD_STAT(STAT_NinjaGAS_CuePoolHits);
+	}
+	else
+	{
+		++Stats.Misses;
+		INC_DWORD_STAT(STAT_NinjaGAS_CuePoolMisses);
+	}
+}
+
+void UNinjaGASWorldSubsystem::RecordCueNotifyFinished(const UClass* NotifyClass, const bool bRecycled)
+{
+	FNinjaCueNotifyPoolStats& Stats = CueNotifyPoolStats.FindOrAdd(NotifyClass);
+	if (bRecycled)
+	{
+		++Stats.Recycled;
+	}
+	else
+	{
+		++Stats.Destroyed;
+	}
+}
+
+FNinjaCueNotifyPoolStats UNinjaGASWorldSubsystem::GetCueNotifyPoolStats(const TSubclassOf<AGameplayCueNotify_Actor> NotifyClass) const
+{
+	return CueNotifyPoolStats.FindRef(NotifyClass.Get());
+}
+
+FNinjaCueNotifyPoolStats UNinjaGASWorldSubsystem::GetCueNotifyPoolTotals() const
+{
+	FNinjaCueNotifyPoolStats Totals;
+	for (const TPair<TObjectKey<UClass>, FNinjaCueNotifyPoolStats>& Entry : CueNotifyPoolStats)
+	{
+		Totals.Prewarmed += Entry.Value.Prewarmed;
+		Totals.Hits += Entry.Value.Hits;
+		Totals.Misses += Entry.Value.Misses;
+		Totals.Recycled += Entry.Value.Recycled;
+		Totals.Destroyed += Entry.Value.Destroyed;
+	}
+
+	return Totals;
+}
+
+void UNinjaGASWorldSubsystem::AddCueNotifyPools(const TArray<FNinjaCueNotifyPool>& CueNotifyPools)
+{
+	for (const FNinjaCueNotifyPool& CueNotifyPool : CueNotifyPools)
+	{
+		UClass* NotifyClass = CueNotifyPool.NotifyClass.Get();
+		if (!IsValid(NotifyClass))
+		{
+			continue;
+		}
+
+		int32& PoolSize = CueNotifyPoolSizes.FindOrAdd(NotifyClass);
+		if (CueNotifyPool.PoolSize > PoolSize)
+		{
+			// Pooling keeps the designer's setting, so these instances only return once they end themselves.
+			const AGameplayCueNotify_Actor* NotifyDefaults = Cast<AGameplayCueNotify_Actor>(NotifyClass->GetDefaultObject());
+			if (PoolSize == 0 && IsValid(NotifyDefaults) && !NotifyDefaults->bAutoDestroyOnRemove)
+			{
+				UE_LOG(LogNinjaGAS, Warning, TEXT("Pooled cue notify %s does not auto destroy on remove. Instances only return to the pool once they call K2_EndGameplayCue."),
+					*GetNameSafe(NotifyClass));
+			}
+			
+			PoolSize = CueNotifyPool.PoolSize;
+			PendingCueNotifyPools.AddUnique(NotifyClass);
+		}
+	}
+}
+
+void UNinjaGASWorldSubsystem::PrewarmPendingCueNotifyPools()
+{
+	if (PendingCueNotifyPools.IsEmpty())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	UNinjaGASGameplayCueManager* CueManager = Cast<UNinjaGASGameplayCueManager>(UAbilitySystemGlobals::Get().GetGameplayCueManager());
+	if (!IsValid(World) || !IsValid(CueManager))
+	{
+		PendingCueNotifyPools.Reset();
+		return;
+	}
+
+	int32 Budget = FMath::Max(GCueNotifyPoolPrewarmPerFrame, 1);
+	for (int32 Index = PendingCueNotifyPools.Num() - 1; Index >= 0 && Budget > 0; --Index)
+	{
+		UClass* NotifyClass = PendingCueNotifyPools[Index].Get();
+		const int32 PoolSize = NotifyClass ? CueNotifyPoolSizes.FindRef(NotifyClass) : 0;
+		
+		int32 Pooled = CueManager->GetPooledCueNotifyCount(World, NotifyClass);
+		while (Pooled < PoolSize && Budget > 0 && CueManager->PrewarmCueNotifyActor(World, NotifyClass))
+		{
+			++CueNotifyPoolStats.FindOrAdd(NotifyClass).Prewarmed;
+			++Pooled;
+			--Budget;
+		}
+
+		// Classes that failed to spawn are dropped as well, instead of retrying every frame.
+		if (Pooled >= PoolSize || Budget > 0)
+		{
+			PendingCueNotifyPools.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+void UNinjaGASWorldSubsystem::FlushLocalGameplayCues()
+{
+	// Merging only applies within a frame, so deferred cues are kept in order and handled as queued.
+	QueuedGameplayCueIndices.Reset();
+
+	if (QueuedGameplayCues.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_NinjaGAS_LocalCuesFlush);
+	
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	const int32 Budget = GLocalGameplayCuesMaxPerFrame > 0 ? GLocalGameplayCuesMaxPerFrame : MAX_int32;
+
+	int32 Handled = 0;
+	int32 Consumed = 0;
+	
+	for (; Consumed < QueuedGameplayCues.Num() && Handled < Budget; ++Consumed)
+	{
+		// Copied, since cue notifies may queue more cues while being handled.
+		const FQueuedGameplayCue QueuedCue = QueuedGameplayCues[Consumed];
+		AActor* Target = QueuedCue.Target.Get();
+		if (QueuedCue.bCancelled || !IsValid(Target) || !IsValid(CueManager))
+		{
+			continue;
+		}
+
+		CueManager->HandleGameplayCue(Target, QueuedCue.GameplayCueTag, QueuedCue.EventType, QueuedCue.Parameters);
+		if (QueuedCue.EventType == EGameplayCueEvent::OnActive)
+		{
+			CueManager->HandleGameplayCue(Target, QueuedCue.GameplayCueTag, EGameplayCueEvent::WhileActive, QueuedCue.Parameters);
+		}
+		
+		++Handled;
+	}
+
+	QueuedGameplayCues.RemoveAt(0, Consumed, EAllowShrinking::No);
+	QueuedGameplayCueIndices.Reset();
+	
+	INC_DWORD_STAT_BY(STAT_NinjaGAS_LocalCuesHandled, Handled);
+	SET_DWORD_STAT(STAT_NinjaGAS_LocalCuesDeferred, QueuedGameplayCues.Num());
+}
+
+void UNinjaGASWorldSubsystem::RegisterAbilitySystem(UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	if (!IsValid(AbilityComponent) || TickEntryIndices.Contains(AbilityComponent))
+	{
+		return;
+	}
+
+	FTickEntry Entry;
+	Entry.AbilityComponent = AbilityComponent;
+	Entry.AbilityComponentKey = AbilityComponent;
+	RefreshTickInterval(Entry);
+	
+	const int32 Index = TickEntries.Add(Entry);
+	TickEntryIndices.Add(AbilityComponent, Index);
+}
+
+void UNinjaGASWorldSubsystem::UnregisterAbilitySystem(const UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	if (const int32* Index = TickEntryIndices.Find(AbilityComponent))
+	{
+		RemoveTickEntryAt(*Index);
+	}
+}
+
+bool UNinjaGASWorldSubsystem::IsAbilitySystemRegistered(const UNinjaGASAbilitySystemComponent* AbilityComponent) const
+{
+	return TickEntryIndices.Contains(AbilityComponent);
+}
+
+void UNinjaGASWorldSubsystem::RegisterHibernationCandidate(UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	if (IsValid(AbilityComponent))
+	{
+		HibernationCandidates.AddUnique(AbilityComponent);
+	}
+}
+
+void UNinjaGASWorldSubsystem::UnregisterHibernationCandidate(const UNinjaGASAbilitySystemComponent* AbilityComponent)
+{
+	HibernationCandidates.RemoveSingleSwap(AbilityComponent, EAllowShrinking::No);
+}
+
+void UNinjaGASWorldSubsystem::SetAbilitySystemTickInterval(const UNinjaGASAbilitySystemComponent* AbilityComponent, const float TickInterval)
+{
+	const int32* Index = TickEntryIndices.Find(AbilityComponent);
+	if (Index == nullptr)
+	{
+		return;
+	}
+
+	FTickEntry& Entry = TickEntries[*Index];
+	Entry.bExplicitInterval = TickInterval >= 0.f;
+	
+	if (Entry.bExplicitInterval)
+	{
+		Entry.TickInterval = TickInterval;
+	}
+	else
+	{
+		RefreshTickInterval(Entry);
+	}
+}
+
+float UNinjaGASWorldSubsystem::GetDistanceToClosestViewer(const FVector& Location) const
+{
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (const FVector& ViewerLocation : ViewerLocations)
+	{
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, static_cast<float>(FVector::DistSquared(Location, ViewerLocation)));
+	}
+
+	return ViewerLocations.IsEmpty() ? TNumericLimits<float>::Max() : FMath::Sqrt(ClosestDistanceSquared);
+}
+
+float UNinjaGASWorldSubsystem::GetDistanceToClosestViewer(const UNinjaGASAbilitySystemComponent* AbilityComponent) const
+{
+	if (!IsValid(AbilityComponent))
+	{
+		return TNumericLimits<float>::Max();
+	}
+	
+	const AActor* Avatar = AbilityComponent->GetAvatarActor();
+	const AActor* Reference = IsValid(Avatar) ? Avatar : AbilityComponent->GetOwner();
+	return IsValid(Reference) ? GetDistanceToClosestViewer(Reference->GetActorLocation()) : TNumericLimits<float>::Max();
+}
+
+FNinjaCentralTickStats UNinjaGASWorldSubsystem::GetCentralTickStats() const
+{
+	return CentralTickStats;
+}
+
+void UNinjaGASWorldSubsystem::RefreshViewerLocations()
+{
+	ViewerLocations.Reset();
+
+	const UWorld* World = GetWorld();
+	if (!IsValid(World))
+	{
+		return;
+	}
+	
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (!IsValid(PlayerController))
+		{
+			continue;
+		}
+
+		const APawn* Pawn = PlayerController->GetPawn();
+		ViewerLocations.Add(IsValid(Pawn) ? Pawn->GetActorLocation() : PlayerController->GetFocalLocation());
+	}
+}
+
+void UNinjaGASWorldSubsystem::RefreshTickInterval(FTickEntry& Entry) const
+{
+	const UNinjaGASAbilitySystemComponent* AbilityComponent = Entry.AbilityComponent.Get();
+	if (!IsValid(AbilityComponent) || !AbilityComponent->HasCentralTickDistanceBands())
+	{
+		Entry.TickInterval = 0.f;
+		return;
+	}
+
+	Entry.TickInterval = AbilityComponent->GetCentralTickInterval(GetDistanceToClosestViewer(AbilityComponent));
+}
+
+void UNinjaGASWorldSubsystem::RefreshHibernation()
+{
+	// Without viewers, every distance is unknown, so all candidates hibernate until a player joins.
+	for (int32 Index = HibernationCandidates.Num() - 1; Index >= 0; --Index)
+	{
+		UNinjaGASAbilitySystemComponent* AbilityComponent = HibernationCandidates[Index].Get();
+		if (!IsValid(AbilityComponent))
+		{
+			HibernationCandidates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		AbilityComponent->UpdateHibernation(GetDistanceToClosestViewer(AbilityComponent));
+	}
+}
+
+void UNinjaGASWorldSubsystem::RemoveTickEntryAt(const int32 Index)
+{
+	check(TickEntries.IsValidIndex(Index));
+	
+	TickEntryIndices.Remove(TickEntries[Index].AbilityComponentKey);
+
+	if (bTickingAbilitySystems)
+	{
+		// Swapping now would move an entry that was already ticked into a slot not yet visited.
+		FTickEntry& Entry = TickEntries[Index];
+		Entry.AbilityComponent.Reset();
+		Entry.bPendingRemoval = true;
+		bHasPendingTickEntryRemovals = true;
+		return;
+	}
+	
+	TickEntries.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (TickEntries.IsValidIndex(Index))
+	{
+		TickEntryIndices.Add(TickEntries[Index].AbilityComponentKey, Index);
+	}
+}
+
+void UNinjaGASWorldSubsystem::CompactTickEntries()
+{
+	TickEntries.RemoveAll([](const FTickEntry& Entry) { return Entry.bPendingRemoval; });
+	
+	TickEntryIndices.Reset();
+	for (int32 Index = 0; Index < TickEntries.Num(); ++Index)
+	{
+		TickEntryIndices.Add(TickEntries[Index].AbilityComponentKey, Index);
+	}
+
+	bHasPendingTickEntryRemovals = false;
+}
@@ -6,10 +6,17 @@
 #include "Interfaces/AbilitySystemDefaultsInterface.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "Types/FNinjaAbilityDefaults.h"
+#include "Types/FNinjaActiveAbilityRecord.h"
+#include "Types/FNinjaEffectBatchResult.h"
+#include "Types/FNinjaGameplayCueBatch.h"
+#include "Types/FNinjaTickDistanceBand.h"
 #include "NinjaGASAbilitySystemComponent.generated.h"
 
 class UNinjaGASDataAsset;
+class UNinjaGASSubsystem;
+class UNinjaGASWorldSubsystem;
 class UAnimMontage;
+struct FStreamableHandle;
 
 /**
  * CVAR to control the "Play Montage" flow.
@@ -43,6 +50,7 @@ class NINJAGAS_API UNinjaGASAbilitySystemComponent : public UAbilitySystemCompon
 {
 
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAbilitySystemAvatarChangedSignature, AActor*, NewAvatar);
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAbilitySystemDefaultsInitializedSignature, const UNinjaGASDataAsset*, AbilityData);
 	
 	GENERATED_BODY()
 
@@ -51,14 +59,36 @@ public:
 	/** Broadcasts a changed in the Avatar. */
 	UPROPERTY(BlueprintAssignable)
 	FAbilitySystemAvatarChangedSignature OnAbilitySystemAvatarChanged;
+
+	/** Broadcasts once defaults from a data asset were granted, which may happen after its bundle is loaded. */
+	UPROPERTY(BlueprintAssignable)
+	FAbilitySystemDefaultsInitializedSignature OnAbilitySystemDefaultsInitialized;
 	
 	UNinjaGASAbilitySystemComponent();
 
+	// -- Begin Actor Component implementation
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	// -- End Actor Component implementation
+	
+	// -- Begin Gameplay Tasks Component implementation
+	virtual bool GetShouldTick() const override;
+	// -- End Gameplay Tasks Component implementation
+	
 	// -- Begin Ability System Component implementation
 	virtual void InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor) override;
 	virtual void ClearActorInfo() override;
 	virtual bool ShouldDoServerAbilityRPCBatch() const override;
 	virtual float PlayMontage(UGameplayAbility* AnimatingAbility, FGameplayAbilityActivationInfo ActivationInfo, UAnimMontage* Montage, float InPlayRate, FName StartSectionName = NAME_None, float StartTimeSeconds = 0.0f) override;
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
+	virtual void NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled) override;
+	virtual void Call_InvokeGameplayCueExecuted(const FGameplayTag GameplayCueTag, FPredictionKey PredictionKey, FGameplayEffectContextHandle EffectContext) override;
+	virtual void Call_InvokeGameplayCuesExecuted(const FGameplayTagContainer GameplayCueTags, FPredictionKey PredictionKey, FGameplayEffectContextHandle EffectContext) override;
+	virtual void Call_InvokeGameplayCueExecuted_WithParams(const FGameplayTag GameplayCueTag, FPredictionKey PredictionKey, FGameplayCueParameters GameplayCueParameters) override;
+	virtual void Call_InvokeGameplayCuesExecuted_WithParams(const FGameplayTagContainer GameplayCueTags, FPredictionKey PredictionKey, FGameplayCueParameters GameplayCueParameters) override;
+	virtual void Call_InvokeGameplayCueAdded_WithParams(const FGameplayTag GameplayCueTag, FPredictionKey PredictionKey, FGameplayCueParameters Parameters) override;
+	virtual void Call_InvokeGameplayCueAddedAndWhileActive_WithParams(const FGameplayTag GameplayCueTag, FPredictionKey PredictionKey, FGameplayCueParameters GameplayCueParameters) override;
+	virtual void Call_InvokeGameplayCuesAddedAndWhileActive_WithParams(const FGameplayTagContainer GameplayCueTags, FPredictionKey PredictionKey, FGameplayCueParameters GameplayCueParameters) override;
 	// -- End Ability System Component implementation
 
 	// -- Begin Ability System Defaults implementation
@@ -84,6 +114,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|Ability System")
 	FActiveGameplayEffectHandle ApplyGameplayEffectClassToSelf(TSubclassOf<UGameplayEffect> EffectClass, float Level = 1);
 
+	/**
+	 * Applies the same outgoing spec to multiple targets, in a single pass.
+	 *
+	 * The spec, its context and the source attributes it captured are shared by all targets.
+	 * Target components are resolved together and gameplay cues triggered by the applications
+	 * are only sent once all targets were processed.
+	 *
+	 * @param Spec				Outgoing spec, usually created by this component.
+	 * @param Targets			Actors receiving the effect. Actors without an Ability System Component are skipped.
+	 * @param OutHandles		Handle for each target, in the same order. Invalid for skipped targets.
+	 * @param PredictionKey		Prediction key for the applications, if predicted.
+	 * @return					Summary of the batch, including its throughput.
+	 */
+	FNinjaEffectBatchResult ApplyGameplayEffectSpecToTargets(const FGameplayEffectSpec& Spec, const TArray<AActor*>& Targets,
+		TArray<FActiveGameplayEffectHandle>& OutHandles, FPredictionKey PredictionKey = FPredictionKey());
+
 	/**
 	 * Grants a new ability to the owner.
 	 * 
@@ -95,6 +141,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|Ability System")
 	FGameplayAbilitySpecHandle GiveAbilityFromClass(const TSubclassOf<UGameplayAbility> AbilityClass, int32 Level = 1, int32 Input = -1);
 
+	/**
+	 * Grants multiple abilities to the owner, in a single pass.
+	 *
+	 * Capacity is reserved once, replication IDs are assigned once all specs are in place and
+	 * a single summary is logged. If the ability list is locked, falls back to "GiveAbility",
+	 * which defers each spec until the lock is released.
+	 *
+	 * @param AbilitySpecs		Specs to grant. Specs without a valid ability are skipped.
+	 * @param OutHandles		Handles for each spec, in the same order. Invalid for skipped specs.
+	 */
+	void GiveAbilitiesBatch(const TArray<FGameplayAbilitySpec>& AbilitySpecs, TArray<FGameplayAbilitySpecHandle>& OutHandles);
+
 	/**
 	 * Tries to activate the ability by the handle, aggregating all RPCs that happened in the same frame.
 	 *
@@ -108,6 +166,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|Ability System")
 	virtual bool TryBatchActivateAbility(FGameplayAbilitySpecHandle AbilityHandle, bool bEndAbilityImmediately);
 
+	/**
+	 * Tries to activate multiple abilities together, sending all their RPCs to the server in a single call.
+	 *
+	 * @param AbilityHandles
+	 *		Handles used to identify the abilities, activated in the provided order.
+	 *
+	 * @param bEndAbilitiesImmediately
+	 *		Determines if the EndAbility is triggered right away or later, with its own RPC. This requires the Abilities
+	 *		to either implement IBatchGameplayAbilityInterface or be a subclass of NinjaGASGameplayAbility.
+	 *
+	 * @param OutActivated
+	 *		Activation result for each handle, in the same order.
+	 *
+	 * @return
+	 *		Amount of abilities activated.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|Ability System")
+	virtual int32 TryBatchActivateAbilities(const TArray<FGameplayAbilitySpecHandle>& AbilityHandles, bool bEndAbilitiesImmediately, TArray<bool>& OutActivated);
+
 	/**
 	 * Cancels Gameplay Abilities by their matching tags.
 	 *
@@ -145,9 +222,190 @@ public:
 	 */		
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, Category = "Ninja GAS|Ability System", meta = (AutoCreateRefTerm = "GameplayCueParameters"))
 	void RemoveGameplayCueLocally(UPARAM(meta = (Categories = "GameplayCue")) const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters) const;
+
+	/**
+	 * Finds an Ability Spec by its handle, using the indexed positions instead of a linear scan.
+	 *
+	 * @param Handle			Handle identifying the Ability Spec.
+	 * @return					The matching Ability Spec, or null if the handle is not granted.
+	 */
+	const FGameplayAbilitySpec* FindAbilitySpecByHandle(FGameplayAbilitySpecHandle Handle) const;
+
+	/**
+	 * Finds the first Ability Spec granted for a given class, using the class index.
+	 *
+	 * @param AbilityClass		Exact ability class to look for.
+	 * @return					The first matching Ability Spec, or null if the class is not granted.
+	 */
+	const FGameplayAbilitySpec* FindAbilitySpecByClass(const TSubclassOf<UGameplayAbility>& AbilityClass) const;
+
+	/**
+	 * Finds all Ability Specs whose ability asset tags match the provided tags, using the tag index.
+	 *
+	 * Follows the same matching rules as "FindAllAbilitiesWithTags", without resolving each handle again.
+	 *
+	 * @param Tags				Tags that must be present in the ability's asset tags.
+	 * @param OutSpecs			All Ability Specs matching the provided tags.
+	 * @param bExactMatch		If true, parent tags in the ability are not considered a match.
+	 */
+	void FindAbilitySpecsByTags(const FGameplayTagContainer& Tags, TArray<const FGameplayAbilitySpec*>& OutSpecs, bool bExactMatch = true) const;
+
+	/**
+	 * Finds all Ability Specs bound to a given Input ID, using the input index.
+	 *
+	 * @param InputID			Input ID assigned to the abilities.
+	 * @param OutSpecs			All Ability Specs bound to the provided Input ID.
+	 */
+	void FindAbilitySpecsByInputID(int32 InputID, TArray<const FGameplayAbilitySpec*>& OutSpecs) const;
+
+	/**
+	 * Rebuilds all ability indices from the current activatable abilities.
+	 *
+	 * Indices are maintained automatically when abilities are given or removed. This only needs to
+	 * be called when an existing spec is modified in place, such as when its Input ID is reassigned.
+	 */
+	void RefreshAbilityIndices();
+
+	/**
+	 * Checks if any ability of the exact given class is active, using the active ability counts.
+	 *
+	 * @param AbilityClass		Exact ability class to check.
+	 * @return					True if at least one spec for this class is active.
+	 */
+	bool IsAbilityClassActive(const TSubclassOf<UGameplayAbility>& AbilityClass) const;
+
+	/**
+	 * Checks if any active ability has asset tags matching the provided tags.
+	 *
+	 * Single tags are resolved directly from the active tag counts. Multiple tags are first
+	 * checked against the counts and only then matched against the active abilities.
+	 *
+	 * @param Tags				Tags that must be present in the active ability's asset tags.
+	 * @param bExactMatch		If true, parent tags in the ability are not considered a match.
+	 * @return					True if at least one active ability matches the tags.
+	 */
+	bool HasActiveAbilityWithTags(const FGameplayTagContainer& Tags, bool bExactMatch = true) const;
+
+	/**
+	 * Checks if any ability bound to the given Input ID is active, using the active ability counts.
+	 *
+	 * @param InputID			Input ID assigned to the abilities.
+	 * @return					True if at least one spec for this Input ID is active.
+	 */
+	bool HasActiveAbilityWithInputID(int32 InputID) const;
+
+	/**
+	 * Checks if this component is ticked by the world subsystem, instead of its own component tick.
+	 */
+	bool IsCentrallyTicked() const { return bCentrallyTicked; }
+
+	/**
+	 * Checks if this component has pending work for a central tick, such as ticking tasks or replicated montages.
+	 */
+	bool ShouldTickCentrally() const;
+
+	/**
+	 * Ticks this component from the world subsystem.
+	 *
+	 * @param DeltaTime			Seconds since the last central tick for this component.
+	 */
+	void TickCentrally(float DeltaTime);
+
+	/**
+	 * Checks if distance bands were provided for the central tick.
+	 */
+	bool HasCentralTickDistanceBands() const { return !CentralTickDistanceBands.IsEmpty(); }
+	
+	/**
+	 * Provides the central tick interval for a distance, from the distance bands.
+	 *
+	 * @param DistanceToViewer	Distance from the avatar to the closest viewer.
+	 * @return					Seconds between ticks. Beyond all bands, the last band is used.
+	 */
+	float GetCentralTickInterval(float DistanceToViewer) const;
+
+	/**
+	 * Checks if this component is currently hibernating.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|Ability System")
+	bool IsHibernating() const { return bHibernating; }
+
+	/**
+	 * Checks if this component is allowed to hibernate: enabled, authoritative and not player-controlled.
+	 */
+	bool CanHibernate() const;
+
+	/**
+	 * Puts this component into hibernation or wakes it up.
+	 *
+	 * While hibernating, the component does not tick, periodic effects active when hibernation
+	 * started are paused and the owner replicates at a lower frequency. On wake, all periods
+	 * that would have elapsed are executed, in order, and timers are restored to their phase.
+	 *
+	 * Usually driven by the distance settings, but can also be called by a significance manager.
+	 *
+	 * @param bNewHibernating	Whether the component should hibernate.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Ninja GAS|Ability System")
+	void SetHibernating(bool bNewHibernating);
+
+	/**
+	 * Evaluates hibernation from the distance to the closest viewer, using the hibernation distances.
+	 *
+	 * @param DistanceToViewer	Distance from the avatar to the closest viewer.
+	 */
+	void UpdateHibernation(float DistanceToViewer);
+
+	/**
+	 * Sends all replicated gameplay cues batched in this frame.
+	 *
+	 * Called by the world subsystem at the end of the frame.
+	 */
+	void FlushGameplayCueBatch();
+
+	/**
+	 * Forces the deferred net update requested by montages, if the minimum interval allows it.
+	 *
+	 * Called by the world subsystem at the end of the frame.
+	 *
+	 * @return					False if the update is still pending, due to the minimum interval.
+	 */
+	bool FlushMontageNetUpdate();
+
+	/**
+	 * Checks if ability activations can be added to the frame-scoped server RPC batch.
+	 *
+	 * Requires batch RPCs to be enabled, on a client that sends activations to the server.
+	 */
+	bool CanBatchAbilityRPCsForFrame() const;
+
+	/**
+	 * Opens a server RPC batch for an ability, that stays open until the end of the frame.
+	 *
+	 * Only abilities that opt in, via "Batch RPCs On Input" in NinjaGASGameplayAbility, are batched.
+	 * Activation, target data and end RPCs sent by all batched abilities in this frame are combined
+	 * in a single RPC. Must be called right before activating the ability.
+	 *
+	 * @param AbilityHandle		Handle for the ability about to be activated.
+	 * @return					True if the ability is batched until the end of the frame.
+	 */
+	bool AddToFrameAbilityRPCBatch(FGameplayAbilitySpecHandle AbilityHandle);
+
+	/**
+	 * Closes all server RPC batches opened in this frame, sending the ones with activations.
+	 *
+	 * Called by the world subsystem at the end of the frame.
+	 */
+	void FlushFrameAbilityRPCBatch();
 	
 protected:
 
+	// -- Begin Ability System Component implementation
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void EndServerAbilityRPCBatch(FGameplayAbilitySpecHandle AbilityHandle) override;
+	// -- End Ability System Component implementation
+
 	/**
 	 * Default configuration for the Ability System.
 	 * 
@@ -165,6 +423,100 @@ protected:
 	 */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System", DisplayName = "Enable Ability Batch RPCs")
 	bool bEnableAbilityBatchRPC;
+
+	/**
+	 * Determines if a change in the ability setup only grants and removes the differences.
+	 *
+	 * When enabled, attribute sets, effects, abilities and tags shared by the previous and the
+	 * new setup are kept in place. Instant effects are kept when their attribute sets are kept,
+	 * and executed again when their attribute sets are re-created. If an instant effect cannot
+	 * be reconciled, such as one removed while its attribute set is kept, all defaults are
+	 * cleared and granted again, which is also what happens when this is disabled.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
+	bool bIncrementalDefaultsUpdate;
+
+	/**
+	 * Determines if default attribute sets are initialized from compiled attribute tables.
+	 *
+	 * Compiled tables are shared by all sets of the same class and table, but they write the
+	 * attribute values directly. Only enable this when no default attribute set overrides
+	 * "InitFromMetaDataTable", since that function is not called when this is enabled.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
+	bool bUseCompiledAttributeInitializers;
+
+	/**
+	 * Determines if the "Abilities" bundle from a setup is loaded asynchronously.
+	 *
+	 * When enabled and the bundle is not loaded yet, defaults are granted once the load
+	 * completes, which is notified by "OnAbilitySystemDefaultsInitialized". In that case,
+	 * attributes, effects and abilities are not available yet when "InitAbilityActorInfo"
+	 * returns, so anything depending on them must wait for that delegate. Setups saved before
+	 * bundle data was added must be resaved first. When disabled, any missing asset is loaded
+	 * synchronously and defaults are granted right away.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
+	bool bAsyncLoadDefaults;
+
+	/**
+	 * Determines if this component is ticked by the Ninja GAS World Subsystem.
+	 *
+	 * Meant for crowded levels, where many components ticking individually is costly.
+	 * The component tick is disabled and all registered components are ticked together.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System|Tick")
+	bool bUseCentralizedTick;
+
+	/**
+	 * Determines if local gameplay cues are queued in the Ninja GAS World Subsystem.
+	 *
+	 * Queued cues are handled at the end of the frame, merged with identical cues for the
+	 * same target and within a per-frame budget. When disabled, cues are handled right away.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
+	bool bQueueLocalGameplayCues;
+
+	/**
+	 * Determines if replicated gameplay cues are batched per frame.
+	 *
+	 * Cue executions and additions invoked by the server in a frame are sent in a single
+	 * multicast, with identical parameters sent once. Cues from effect specs are not batched.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
+	bool bBatchReplicatedGameplayCues;
+
+	/**
+	 * Tick intervals for the central tick, by distance to the closest viewer, sorted by distance.
+	 *
+	 * When empty, the component is ticked every frame, unless an interval is set in the subsystem.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System|Tick", meta = (EditCondition = "bUseCentralizedTick", TitleProperty = "MaxDistance"))
+	TArray<FNinjaTickDistanceBand> CentralTickDistanceBands;
+
+	/**
+	 * Determines if this component can hibernate, when far from all viewers.
+	 *
+	 * Only applies to authoritative components whose avatar is not controlled by a player.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System|Hibernation")
+	bool bEnableHibernation;
+
+	/**
+	 * Distance from the closest viewer where this component starts hibernating.
+	 *
+	 * When zero, hibernation is only driven by calls to "SetHibernating".
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System|Hibernation", meta = (EditCondition = "bEnableHibernation", ClampMin = "0", Units = "cm"))
+	float HibernationDistance;
+
+	/** Distance from the closest viewer where a hibernating component wakes up. Should be below the hibernation distance. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System|Hibernation", meta = (EditCondition = "bEnableHibernation", ClampMin = "0", Units = "cm"))
+	float WakeDistance;
+
+	/** Net update frequency for the owner, while hibernating. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System|Hibernation", meta = (EditCondition = "bEnableHibernation", ClampMin = "0.1"))
+	float HibernationNetUpdateFrequency;
 	
 	/**
 	 * Initializes default abilities, effects and attribute sets.
@@ -174,11 +526,36 @@ protected:
 	 */
 	void InitializeDefaults(const AActor* NewAvatarActor);
 
+	/**
+	 * Provides the Data Asset for an avatar: from the avatar's interface, or the one from this component.
+	 */
+	const UNinjaGASDataAsset* ResolveAbilityData(const AActor* NewAvatarActor) const;
+
+	/**
+	 * Requests the "Abilities" bundle from the Data Asset, applying it once loaded.
+	 */
+	void LoadAbilityData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData);
+
+	/**
+	 * Applies a Data Asset that finished loading, if it is still the expected setup for the avatar.
+	 */
+	void HandleAbilityDataLoaded(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData);
+
+	/**
+	 * Applies a loaded Data Asset, either incrementally or by clearing the current defaults.
+	 */
+	void ApplyAbilityData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData);
+	
 	/**
 	 * Initializes Abilities from the provided Data Asset.
 	 */
 	void InitializeFromData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData);
 	
+	/**
+	 * Updates the current defaults to match a new Data Asset, granting and removing only the differences.
+	 */
+	void UpdateFromData(const AActor* NewAvatarActor, const UNinjaGASDataAsset* AbilityData);
+	
 	/**
 	 * Initializes Attribute Sets provided by the interface.
 	 */
@@ -186,6 +563,9 @@ protected:
 
 	/**
 	 * Initializes the Gameplay Effects provided by the interface.
+	 *
+	 * All effects are applied under a single gameplay cue window, so their cues are sent together
+	 * once the whole list was applied.
 	 */
 	void InitializeGameplayEffects(const TArray<FDefaultGameplayEffect>& GameplayEffects);
 
@@ -199,6 +579,21 @@ protected:
 	 */
 	virtual void ClearDefaults();
 
+	/**
+	 * Invokes all cues from a batch, skipping the ones predicted by this client.
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void NetMulticast_InvokeGameplayCueBatch(const FNinjaGameplayCueBatch& Batch);
+
+	/**
+	 * Handles server RPC batches from multiple abilities, collected by the client and sent together.
+	 *
+	 * Clients send at most MaxAbilityRPCBatchesPerCall batches per call, so larger arrays are rejected.
+	 * Batches for abilities that are no longer granted are skipped.
+	 */
+	UFUNCTION(Server, Reliable, WithValidation)
+	void Server_AbilityRPCBatches(const TArray<FServerAbilityRPCBatch>& Batches);
+	
 	/**
 	 * Conveniently separates the code that sets the animation to replicate, so it can be further modified.
 	 */
@@ -209,17 +604,185 @@ private:
 	/** Actual ability setup used to initialize this ASC. */
 	UPROPERTY()
 	TObjectPtr<const UNinjaGASDataAsset> CurrentAbilitySetup;
+
+	/** Ability setup waiting for its bundle to load. */
+	UPROPERTY()
+	TObjectPtr<const UNinjaGASDataAsset> PendingAbilitySetup;
+
+	/** Keeps the bundle from the current ability setup loaded. */
+	TSharedPtr<FStreamableHandle> AbilityDataHandle;
+
+	/** Handle for the bundle being loaded for the pending ability setup. */
+	TSharedPtr<FStreamableHandle> PendingAbilityDataHandle;
 	
 	/** Attribute sets we initialized and are keeping track. */
 	UPROPERTY()
 	TArray<TObjectPtr<UAttributeSet>> AddedAttributes;
 	
+	/** Entries used to create each one of the added attribute sets. */
+	UPROPERTY()
+	TArray<FDefaultAttributeSet> AddedAttributeEntries;
+	
 	/** All effects we initialized by default. */
 	UPROPERTY()
 	TArray<FActiveGameplayEffectHandle> DefaultEffectHandles;
+
+	/** Entries used to apply each one of the default effects. */
+	UPROPERTY()
+	TArray<FDefaultGameplayEffect> DefaultEffectEntries;
 	
 	/** All abilities we initialized by default. */
 	UPROPERTY()
 	TArray<FGameplayAbilitySpecHandle> DefaultAbilityHandles;
 
+	/** Entries used to grant each one of the default abilities. */
+	UPROPERTY()
+	TArray<FDefaultGameplayAbility> DefaultAbilityEntries;
+
+	/** Granted ability handles, indexed by the exact ability class. */
+	TMap<TObjectKey<UClass>, TArray<FGameplayAbilitySpecHandle>> AbilityHandlesByClass;
+
+	/** Granted ability handles, indexed by each asset tag and its parents. */
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle>> AbilityHandlesByTag;
+
+	/** Granted ability handles, indexed by Input ID. */
+	TMap<int32, TArray<FGameplayAbilitySpecHandle>> AbilityHandlesByInputID;
+
+	/** Input ID each handle was indexed with, so it can be removed even if the spec changed. */
+	TMap<FGameplayAbilitySpecHandle, int32> IndexedInputIDs;
+
+	/** Position of each handle in the activatable abilities array. Rebuilt lazily. */
+	mutable TMap<FGameplayAbilitySpecHandle, int32> AbilitySpecIndices;
+
+	/** Marks the spec positions as outdated, since the activatable abilities array changed. */
+	mutable bool bAbilitySpecIndicesDirty;
+
+	/** Abilities currently active, by handle. */
+	TMap<FGameplayAbilitySpecHandle, FNinjaActiveAbilityRecord> ActiveAbilityRecords;
+
+	/** Amount of active specs, by exact ability class. */
+	TMap<TObjectKey<UClass>, int32> ActiveAbilityClassCounts;
+
+	/** Amount of active specs, by each exact asset tag. */
+	TMap<FGameplayTag, int32> ActiveAbilityExactTagCounts;
+
+	/** Amount of active specs, by each asset tag and its parents. */
+	TMap<FGameplayTag, int32> ActiveAbilityTagCounts;
+
+	/** Amount of active specs, by Input ID. */
+	TMap<int32, int32> ActiveAbilityInputIDCounts;
+	
+	/** Adds a spec to the class, tag and input indices. */
+	void IndexAbilitySpec(const FGameplayAbilitySpec& AbilitySpec);
+
+	/** Removes a spec from the class, tag and input indices. */
+	void UnindexAbilitySpec(const FGameplayAbilitySpec& AbilitySpec);
+
+	/** Rebuilds the handle to position map, from the activatable abilities array. */
+	void RebuildAbilitySpecIndices() const;
+
+	/** Handles keeping ability dependencies loaded while the ability is granted. */
+	TMap<FGameplayAbilitySpecHandle, TSharedPtr<FStreamableHandle>> AbilityDependencyHandles;
+
+	/** Granted abilities that already activated at least once. */
+	TSet<FGameplayAbilitySpecHandle> FirstActivatedAbilities;
+
+	/** Set while this component is registered with the world subsystem. */
+	bool bCentrallyTicked;
+
+	/** Set while this component is hibernating. */
+	bool bHibernating;
+
+	/** Periodic effect paused by hibernation. */
+	struct FHibernatedPeriodicEffect
+	{
+		/** Handle for the paused effect. */
+		FActiveGameplayEffectHandle Handle;
+
+		/** Seconds until the next execution, when hibernation started. */
+		float PeriodRemaining = 0.f;
+	};
+
+	/** Periodic effects paused while hibernating. */
+	TArray<FHibernatedPeriodicEffect> HibernatedPeriodicEffects;
+
+	/** World time when hibernation started. */
+	double HibernationStartTime;
+
+	/** Owner net update frequencies, before hibernation. */
+	float PreHibernationNetUpdateFrequency;
+	float PreHibernationMinNetUpdateFrequency;
+
+	/** Pauses periodic effects and lowers replication. */
+	void EnterHibernation();
+
+	/** Executes elapsed periods, restores timers and replication. */
+	void ExitHibernation();
+	
+	/** Provides the game instance subsystem, if available. */
+	UNinjaGASSubsystem* GetNinjaGASSubsystem() const;
+
+	/** Provides the world subsystem, if available. */
+	UNinjaGASWorldSubsystem* GetNinjaGASWorldSubsystem() const;
+
+	/** Replicated gameplay cues invoked in this frame, not sent yet. */
+	FNinjaGameplayCueBatch PendingGameplayCueBatch;
+
+	/** Set while the world subsystem is expected to flush the pending batch. */
+	bool bGameplayCueBatchQueued;
+
+	/** Set while closed server RPC batches are collected, to be sent in a single call. */
+	bool bCollectingAbilityRPCBatches;
+
+	/** Server RPC batches closed while collecting. */
+	TArray<FServerAbilityRPCBatch> CollectedAbilityRPCBatches;
+
+	/** Maximum server RPC batches sent in a single call. */
+	static constexpr int32 MaxAbilityRPCBatchesPerCall = 32;
+
+	/** Sends all collected server RPC batches. A single batch is sent with its regular RPC. */
+	void SendCollectedAbilityRPCBatches();
+
+	/** Ends an ability activated in a batch, through the batch interface. */
+	void EndAbilityFromBatch(FGameplayAbilitySpecHandle AbilityHandle) const;
+
+	/** Abilities with a server RPC batch open until the end of the frame. */
+	TArray<FGameplayAbilitySpecHandle> FrameAbilityRPCBatchHandles;
+
+	/** Set while a forced net update requested by a montage is waiting for the end of the frame. */
+	bool bMontageNetUpdatePending;
+
+	/** World time of the last forced net update requested by a montage. */
+	double LastMontageNetUpdateTime;
+
+	/** Forces a net update on the avatar, right away or coalesced at the end of the frame. */
+	void RequestMontageNetUpdate();
+	
+	/** Checks if replicated gameplay cues should be batched. */
+	bool CanBatchGameplayCues() const;
+
+	/** Adds a replicated gameplay cue to the pending batch, sending it first if full. */
+	void BatchGameplayCue(const FGameplayTag& GameplayCueTag, const FPredictionKey& PredictionKey, ENinjaGameplayCueBatchEvent EventType, const FGameplayCueParameters& GameplayCueParameters);
+
+	/** Sends the pending batch. A single cue is sent with its regular multicast. */
+	void SendGameplayCueBatch();
+	
+	/** Queues a local gameplay cue in the world subsystem, if enabled. Returns false if it should be handled right away. */
+	bool QueueLocalGameplayCue(FGameplayTag GameplayCueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& GameplayCueParameters) const;
+
+	/** Collects the dependencies relevant for this instance: assets, plus cues when not a dedicated server. */
+	void GetAbilityDependencyPaths(const UClass* AbilityClass, TArray<FSoftObjectPath>& OutPaths) const;
+
+	/** Asynchronously loads the dependencies from a newly granted ability that are not resident yet. */
+	void PreloadAbilityDependencies(const FGameplayAbilitySpec& AbilitySpec);
+
+	/** Records how many dependencies were resident, the first time a granted ability activates. */
+	void RecordFirstActivation(FGameplayAbilitySpecHandle Handle);
+	
+	/** Starts or stops tracking a handle as active, so it matches the current state of its spec. */
+	void SyncActiveAbility(FGameplayAbilitySpecHandle Handle);
+
+	/** Stops tracking a handle as active, decrementing all counts it contributed to. */
+	void ReleaseActiveAbility(FGameplayAbilitySpecHandle Handle);
+
 };
@@ -17,6 +17,8 @@ class NINJAGAS_API UNinjaGASGameplayAbility : public UGameplayAbility, public IB
 
 public:
 
+	UNinjaGASGameplayAbility();
+	
 	// Begin Gameplay Ability implementation 
 	virtual void OnAvatarSet(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) override;
 	// End Gameplay Ability implementation
@@ -31,5 +33,27 @@ public:
 	 */
 	UFUNCTION(BlueprintPure, Category = "Ninja GAS|Gameplay Ability")
 	bool IsPassiveAbility() const;
+
+	/**
+	 * Checks if server RPCs from this ability are batched for the frame, when activated by input.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|Gameplay Ability")
+	bool ShouldBatchRPCsOnInput() const { return bBatchRPCsOnInput; }
+
+protected:
+
+	/**
+	 * Determines if server RPCs are batched for the frame, when the ability is activated by input.
+	 *
+	 * Activation, target data and end are sent together at the end of the frame, along with other
+	 * abilities batched in the same frame. Requires "Enable Ability Batch RPCs" in the ASC.
+	 *
+	 * Only enable this for abilities that send all their target data in the activation frame and
+	 * don't send other server RPCs directly, such as replicated events or input presses. The server
+	 * always receives the batched target data, even if empty, and direct RPCs arrive before the
+	 * activation.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability Batching")
+	bool bBatchRPCsOnInput;
 	
 };
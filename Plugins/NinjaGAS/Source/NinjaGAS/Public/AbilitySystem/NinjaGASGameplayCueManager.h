@@ -0,0 +1,51 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayCueManager.h"
+#include "NinjaGASGameplayCueManager.generated.h"
+
+/**
+ * Gameplay Cue Manager that exposes the actor recycling pools, so they can be prewarmed and measured.
+ *
+ * Pools are still the engine's per-world recycling lists. This manager spawns instances into them
+ * ahead of use, on request from the Ninja GAS World Subsystem, and reports each request and finished
+ * instance to that subsystem. Enable it in the project settings, under "GlobalGameplayCueManagerClass".
+ */
+UCLASS()
+class NINJAGAS_API UNinjaGASGameplayCueManager : public UGameplayCueManager
+{
+	
+	GENERATED_BODY()
+
+public:
+
+	// -- Begin Gameplay Cue Manager implementation
+	virtual AGameplayCueNotify_Actor* GetInstancedCueActor(AActor* TargetActor, UClass* GameplayCueNotifyActorClass, const FGameplayCueParameters& Parameters) override;
+	virtual void NotifyGameplayCueActorFinished(AGameplayCueNotify_Actor* Actor) override;
+	// -- End Gameplay Cue Manager implementation
+
+	/**
+	 * Checks if finished cue notify actors are recycled, as per "AbilitySystem.GameplayCueActorRecycle".
+	 */
+	static bool IsActorRecyclingEnabled();
+	
+	/**
+	 * Spawns a hidden instance of a cue notify actor directly into the world's recycling pool.
+	 *
+	 * @param World					World owning the pool.
+	 * @param NotifyClass			Cue notify actor class to spawn.
+	 * @return						True if the instance was spawned and pooled.
+	 */
+	bool PrewarmCueNotifyActor(UWorld* World, UClass* NotifyClass);
+
+	/**
+	 * Provides the amount of instances currently waiting in a world's recycling pool.
+	 *
+	 * @param World					World owning the pool.
+	 * @param NotifyClass			Cue notify actor class to check.
+	 * @return						Pooled instances for the class.
+	 */
+	int32 GetPooledCueNotifyCount(UWorld* World, UClass* NotifyClass);
+	
+};
@@ -0,0 +1,23 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ENinjaGameplayCueBatchEvent.generated.h"
+
+/**
+ * Replicated gameplay cue event, carried by a gameplay cue batch.
+ */
+UENUM()
+enum class ENinjaGameplayCueBatchEvent : uint8
+{
+
+	/** Executes the cue. */
+	Executed,
+
+	/** Adds the cue, triggering "OnActive". */
+	Added,
+
+	/** Adds the cue, triggering "OnActive" and "WhileActive". */
+	AddedAndWhileActive
+	
+};
@@ -3,6 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "Templates/SubclassOf.h"
+#include "UObject/SoftObjectPtr.h"
 #include "FNinjaAbilityDefaults.generated.h"
 
 class UAttributeSet;
@@ -21,20 +22,25 @@ struct NINJAGAS_API FDefaultAttributeSet
 	
 	/** Attribute set class to grant. */
 	UPROPERTY(EditDefaultsOnly, Category = "Attribute Set")
-	TSubclassOf<UAttributeSet> AttributeSetClass;
+	TSoftClassPtr<UAttributeSet> AttributeSetClass;
 
 	/** Data table with default attribute values. */
 	UPROPERTY(EditDefaultsOnly, Category = "Attribute Set", meta = (RequiredAssetDataTags = "RowStructure=/Script/GameplayAbilities.AttributeMetaData"))
-	TObjectPtr<const UDataTable> AttributeTable;
+	TSoftObjectPtr<UDataTable> AttributeTable;
 
 	FDefaultAttributeSet()
 	{
 	}
 	
 	FDefaultAttributeSet(const TSubclassOf<UAttributeSet>& AttributeSet, const UDataTable* AttributeTable)
-		: AttributeSetClass(AttributeSet), AttributeTable(AttributeTable)
+		: AttributeSetClass(AttributeSet.Get()), AttributeTable(const_cast<UDataTable*>(AttributeTable))
 	{
 	}
+
+	bool operator==(const FDefaultAttributeSet& Other) const
+	{
+		return AttributeSetClass == Other.AttributeSetClass && AttributeTable == Other.AttributeTable;
+	}
 };
 
 /**
@@ -48,7 +54,7 @@ struct NINJAGAS_API FDefaultGameplayEffect
 	
 	/** Gameplay Effect class to grant. */
 	UPROPERTY(EditDefaultsOnly, Category = "Gameplay Effect")
-	TSubclassOf<UGameplayEffect> GameplayEffectClass;
+	TSoftClassPtr<UGameplayEffect> GameplayEffectClass;
 
 	/** Initial level. */
 	UPROPERTY(EditDefaultsOnly, Category = "Gameplay Effect")
@@ -59,9 +65,14 @@ struct NINJAGAS_API FDefaultGameplayEffect
 	}
 	
 	FDefaultGameplayEffect(const TSubclassOf<UGameplayEffect>& GameplayEffect, const float Level = 1)
-		: GameplayEffectClass(GameplayEffect), Level(Level)
+		: GameplayEffectClass(GameplayEffect.Get()), Level(Level)
 	{
 	}
+
+	bool operator==(const FDefaultGameplayEffect& Other) const
+	{
+		return GameplayEffectClass == Other.GameplayEffectClass && FMath::IsNearlyEqual(Level, Other.Level);
+	}
 };
 
 /**
@@ -75,7 +86,7 @@ struct NINJAGAS_API FDefaultGameplayAbility
 	
 	/** Gameplay Ability class to grant. */
 	UPROPERTY(EditDefaultsOnly, Category = "Gameplay Ability")
-	TSubclassOf<UGameplayAbility> GameplayAbilityClass;
+	TSoftClassPtr<UGameplayAbility> GameplayAbilityClass;
 
 	/** Initial level. */
 	UPROPERTY(EditDefaultsOnly, Category = "Gameplay Ability")
@@ -90,7 +101,12 @@ struct NINJAGAS_API FDefaultGameplayAbility
 	}
 	
 	FDefaultGameplayAbility(const TSubclassOf<UGameplayAbility>& GameplayAbility, const int32 Level = 1, const float Input = INDEX_NONE)
-		: GameplayAbilityClass(GameplayAbility), Level(Level), Input(Input)
+		: GameplayAbilityClass(GameplayAbility.Get()), Level(Level), Input(Input)
+	{
+	}
+
+	bool operator==(const FDefaultGameplayAbility& Other) const
 	{
+		return GameplayAbilityClass == Other.GameplayAbilityClass && Level == Other.Level && Input == Other.Input;
 	}
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "FNinjaAbilityDependencies.generated.h"
+
+/**
+ * Assets an ability class may need when it activates, collected once per class.
+ */
+struct NINJAGAS_API FNinjaAbilityDependencies
+{
+	/** Soft references from the ability, such as montages and effects. */
+	TArray<FSoftObjectPath> AssetPaths;
+
+	/** Gameplay Cue Notifies for cues referenced by the ability and its effects. */
+	TArray<FSoftObjectPath> CuePaths;
+};
+
+/**
+ * Tracks how many ability dependencies were already resident when abilities first activated.
+ */
+USTRUCT(BlueprintType)
+struct NINJAGAS_API FNinjaAbilityPreloadStats
+{
+
+	GENERATED_BODY();
+
+	/** Abilities that activated for the first time since they were granted. */
+	UPROPERTY(BlueprintReadOnly, Category = "Ability Preload")
+	int32 FirstActivations = 0;
+
+	/** Dependencies that were already loaded, when each ability first activated. */
+	UPROPERTY(BlueprintReadOnly, Category = "Ability Preload")
+	int32 ResidentDependencies = 0;
+
+	/** All dependencies expected by each ability, when it first activated. */
+	UPROPERTY(BlueprintReadOnly, Category = "Ability Preload")
+	int32 TotalDependencies = 0;
+	
+};
@@ -0,0 +1,27 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Snapshot of an active ability, taken when it starts being tracked as active.
+ *
+ * Keeps the exact keys used to increment the active counts, so they can be decremented
+ * consistently, even if the spec was modified or removed while the ability was active.
+ */
+struct NINJAGAS_API FNinjaActiveAbilityRecord
+{
+	/** Exact class of the active ability. */
+	TObjectKey<UClass> AbilityClass;
+
+	/** Asset tags from the active ability. */
+	FGameplayTagContainer AssetTags;
+
+	/** Asset tags from the active ability, including their parents. */
+	FGameplayTagContainer IndexedTags;
+
+	/** Input ID assigned to the spec when it became active. */
+	int32 InputID = INDEX_NONE;
+};
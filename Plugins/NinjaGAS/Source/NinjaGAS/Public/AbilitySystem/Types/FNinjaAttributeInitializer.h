@@ -0,0 +1,53 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FNumericProperty;
+class UAttributeSet;
+class UDataTable;
+
+/**
+ * A single value written by a compiled attribute initializer.
+ */
+struct NINJAGAS_API FNinjaAttributeInitializerEntry
+{
+	/** Offset of the property in the Attribute Set. */
+	int32 Offset = 0;
+
+	/** Numeric property to write through. If null, the property is a Gameplay Attribute Data. */
+	const FNumericProperty* NumericProperty = nullptr;
+
+	/** Base value obtained from the attribute table. */
+	float Value = 0.f;
+};
+
+/**
+ * Attribute initialization data, resolved once for an Attribute Set class and attribute table.
+ *
+ * Produces the same result as "UAttributeSet::InitFromMetaDataTable", but row names and properties
+ * are resolved when compiling, so applying it is a loop over property offsets and values.
+ */
+struct NINJAGAS_API FNinjaAttributeInitializer
+{
+	/** Attribute Set class used to compile the initializer. */
+	const UClass* AttributeSetClass = nullptr;
+
+	/** Values to write, in property order. */
+	TArray<FNinjaAttributeInitializerEntry> Entries;
+
+	/**
+	 * Resolves all attribute values for the class, from the attribute table.
+	 *
+	 * @param InAttributeSetClass	Attribute Set class to compile. Must be valid.
+	 * @param AttributeTable		Table with "FAttributeMetaData" rows. Must be valid.
+	 */
+	void Compile(const UClass* InAttributeSetClass, const UDataTable* AttributeTable);
+
+	/**
+	 * Writes all compiled values to the Attribute Set.
+	 *
+	 * @param AttributeSet			Attribute Set to initialize. Must be of the compiled class.
+	 */
+	void Apply(UAttributeSet* AttributeSet) const;
+};
@@ -0,0 +1,61 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPtr.h"
+#include "FNinjaCueNotifyPool.generated.h"
+
+class AGameplayCueNotify_Actor;
+
+/**
+ * Amount of instances of an actor-based Gameplay Cue Notify to keep ready for use.
+ *
+ * Instances return to the pool when they end. Notifies with "Auto Destroy On Remove" disabled
+ * must call K2_EndGameplayCue themselves, otherwise their instances are never recycled.
+ */
+USTRUCT(BlueprintType)
+struct NINJAGAS_API FNinjaCueNotifyPool
+{
+
+	GENERATED_BODY();
+
+	/** Actor-based Gameplay Cue Notify to pool. */
+	UPROPERTY(EditDefaultsOnly, Category = "Cue Notify Pool")
+	TSoftClassPtr<AGameplayCueNotify_Actor> NotifyClass;
+
+	/** Instances spawned ahead of use. */
+	UPROPERTY(EditDefaultsOnly, Category = "Cue Notify Pool", meta = (ClampMin = "1"))
+	int32 PoolSize = 4;
+	
+};
+
+/**
+ * Tracks how often requests for actor-based Gameplay Cue Notifies were served by a pool.
+ */
+USTRUCT(BlueprintType)
+struct NINJAGAS_API FNinjaCueNotifyPoolStats
+{
+
+	GENERATED_BODY();
+
+	/** Instances spawned ahead of use. */
+	UPROPERTY(BlueprintReadOnly, Category = "Cue Notify Pool")
+	int32 Prewarmed = 0;
+
+	/** Requests served by a pooled instance. */
+	UPROPERTY(BlueprintReadOnly, Category = "Cue Notify Pool")
+	int32 Hits = 0;
+
+	/** Requests that had to spawn a new instance. */
+	UPROPERTY(BlueprintReadOnly, Category = "Cue Notify Pool")
+	int32 Misses = 0;
+
+	/** Instances returned to the pool once finished. */
+	UPROPERTY(BlueprintReadOnly, Category = "Cue Notify Pool")
+	int32 Recycled = 0;
+
+	/** Instances destroyed once finished, instead of returning to the pool. */
+	UPROPERTY(BlueprintReadOnly, Category = "Cue Notify Pool")
+	int32 Destroyed = 0;
+	
+};
@@ -0,0 +1,32 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FNinjaEffectBatchResult.generated.h"
+
+/**
+ * Summary of a Gameplay Effect spec applied to multiple targets in a single batch.
+ */
+USTRUCT(BlueprintType)
+struct NINJAGAS_API FNinjaEffectBatchResult
+{
+
+	GENERATED_BODY();
+
+	/** Targets with an Ability System Component, that received the spec. */
+	UPROPERTY(BlueprintReadOnly, Category = "Effect Batch")
+	int32 TargetsProcessed = 0;
+
+	/** Targets where the effect passed all filters and was applied or executed. */
+	UPROPERTY(BlueprintReadOnly, Category = "Effect Batch")
+	int32 EffectsApplied = 0;
+
+	/** Time spent applying the spec to all targets. */
+	UPROPERTY(BlueprintReadOnly, Category = "Effect Batch")
+	float ElapsedMilliseconds = 0.f;
+
+	/** Throughput of the batch. */
+	UPROPERTY(BlueprintReadOnly, Category = "Effect Batch")
+	float TargetsPerMillisecond = 0.f;
+	
+};
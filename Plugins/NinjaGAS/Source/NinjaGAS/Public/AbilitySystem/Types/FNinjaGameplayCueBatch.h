@@ -0,0 +1,77 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ENinjaGameplayCueBatchEvent.h"
+#include "GameplayCueInterface.h"
+#include "GameplayPrediction.h"
+#include "GameplayTagContainer.h"
+#include "FNinjaGameplayCueBatch.generated.h"
+
+/**
+ * A single replicated gameplay cue, inside a batch.
+ */
+USTRUCT()
+struct NINJAGAS_API FNinjaGameplayCueBatchEntry
+{
+
+	GENERATED_BODY();
+
+	/** Gameplay Tag for the Gameplay Cue. */
+	UPROPERTY()
+	FGameplayTag GameplayCueTag;
+
+	/** Prediction key the cue was invoked with, so predicting clients can skip it. */
+	UPROPERTY()
+	FPredictionKey PredictionKey;
+
+	/** Event being replicated. */
+	UPROPERTY()
+	ENinjaGameplayCueBatchEvent EventType = ENinjaGameplayCueBatchEvent::Executed;
+
+	/** Position of the parameters for this cue, in the batch. */
+	UPROPERTY()
+	uint8 ParametersIndex = 0;
+	
+};
+
+/**
+ * All replicated gameplay cues invoked by an Ability System Component in a frame.
+ *
+ * Parameters are stored once and shared by all cues using identical parameters.
+ */
+USTRUCT()
+struct NINJAGAS_API FNinjaGameplayCueBatch
+{
+
+	GENERATED_BODY();
+
+	/** Cues in the batch, in the order they were invoked. */
+	UPROPERTY()
+	TArray<FNinjaGameplayCueBatchEntry> Entries;
+
+	/** Unique parameters used by the cues. */
+	UPROPERTY()
+	TArray<FGameplayCueParameters> Parameters;
+
+	/** Maximum amount of unique parameters in a batch, limited by the index size. */
+	static constexpr int32 MaxParameters = MAX_uint8 + 1;
+
+	/**
+	 * Adds a cue to the batch, reusing identical parameters already in the batch.
+	 *
+	 * @param GameplayCueTag		Gameplay Tag for the Gameplay Cue.
+	 * @param PredictionKey			Prediction key the cue was invoked with.
+	 * @param EventType				Event being replicated.
+	 * @param CueParameters			Parameters for the Gameplay Cue.
+	 * @return						False if the parameters did not fit and the cue was not added.
+	 */
+	bool Add(const FGameplayTag& GameplayCueTag, const FPredictionKey& PredictionKey, ENinjaGameplayCueBatchEvent EventType, const FGameplayCueParameters& CueParameters);
+
+	/** Checks if the batch has no cues. */
+	bool IsEmpty() const { return Entries.IsEmpty(); }
+
+	/** Removes all cues and parameters. */
+	void Reset();
+	
+};
@@ -0,0 +1,48 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimMontage;
+
+/**
+ * Global cache of montage section indices, by section name.
+ *
+ * Produces the same result as "UAnimMontage::GetSectionIndex", but each montage is scanned once,
+ * on first use. In the editor, a montage is scanned again after it is modified. Dynamic montages
+ * are created per play, so they are never cached. Must only be used from the game thread.
+ */
+struct NINJAGAS_API FNinjaMontageSectionCache
+{
+	/**
+	 * Provides the index of a section in a montage.
+	 *
+	 * @param Montage			Montage containing the section.
+	 * @param SectionName		Name of the section.
+	 * @return					Index of the section, or INDEX_NONE if the montage has no such section.
+	 */
+	static int32 GetSectionIndex(const UAnimMontage* Montage, FName SectionName);
+
+	/**
+	 * Discards the cached indices for a montage.
+	 *
+	 * @param Montage			Montage that changed.
+	 */
+	static void Invalidate(const UObject* Montage);
+
+	/**
+	 * Discards all cached indices.
+	 */
+	static void Reset();
+	
+	/**
+	 * Starts invalidating montages modified in the editor. Called by the module.
+	 */
+	static void Initialize();
+
+	/**
+	 * Stops invalidating montages and releases all cached indices. Called by the module.
+	 */
+	static void Shutdown();
+	
+};
@@ -0,0 +1,24 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FNinjaTickDistanceBand.generated.h"
+
+/**
+ * Tick interval used by a centrally ticked Ability System Component, within a distance from the closest viewer.
+ */
+USTRUCT(BlueprintType)
+struct NINJAGAS_API FNinjaTickDistanceBand
+{
+
+	GENERATED_BODY();
+
+	/** Maximum distance from the closest viewer where this band applies. */
+	UPROPERTY(EditDefaultsOnly, Category = "Tick Distance Band", meta = (ClampMin = "0", Units = "cm"))
+	float MaxDistance = 0.f;
+
+	/** Seconds between ticks within this band. Zero ticks every frame. */
+	UPROPERTY(EditDefaultsOnly, Category = "Tick Distance Band", meta = (ClampMin = "0", Units = "s"))
+	float TickInterval = 0.f;
+	
+};
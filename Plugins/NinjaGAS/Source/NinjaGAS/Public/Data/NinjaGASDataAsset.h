@@ -4,7 +4,9 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "AbilitySystem/Types/FNinjaAbilityDefaults.h"
+#include "AbilitySystem/Types/FNinjaCueNotifyPool.h"
 #include "Engine/DataAsset.h"
+#include "Engine/StreamableManager.h"
 #include "NinjaGASDataAsset.generated.h"
 
 /**
@@ -21,6 +23,9 @@ public:
 	/** Asset type that uniquely identifies this data asset. */
 	static FPrimaryAssetType AssetType;	
 
+	/** Asset bundle containing all attribute sets, effects and abilities. */
+	static const FName AbilitiesBundle;
+
 	/** List of Attribute Sets assigned to an avatar. */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Abilities", meta = (AssetBundles = "Abilities", TitleProperty = "AttributeSetClass"))
 	TArray<FDefaultAttributeSet> DefaultAttributeSets;
@@ -36,6 +41,15 @@ public:
 	/** Gameplay tags that are added by default to the owner's ASC. */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Abilities")
 	FGameplayTagContainer InitialGameplayTags;
+
+	/**
+	 * Actor-based Gameplay Cue Notifies to keep pooled while avatars use this setup.
+	 *
+	 * Pools are prewarmed on game clients and listen servers once an avatar is initialized.
+	 * Requires the Gameplay Cue Manager to be a "UNinjaGASGameplayCueManager".
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Cues", meta = (TitleProperty = "NotifyClass"))
+	TArray<FNinjaCueNotifyPool> CueNotifyPools;
 	
 	UNinjaGASDataAsset();
 
@@ -43,4 +57,27 @@ public:
 	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
 	// -- End Primary Data Asset implementation
 
+	/**
+	 * Collects all soft references from the "Abilities" bundle.
+	 *
+	 * @param OutPaths			Paths for all attribute sets, tables, effects and abilities.
+	 */
+	void GetAbilityBundlePaths(TArray<FSoftObjectPath>& OutPaths) const;
+
+	/**
+	 * Checks if all soft references from the "Abilities" bundle are loaded.
+	 */
+	bool IsAbilityBundleLoaded() const;
+
+	/**
+	 * Asynchronously loads the "Abilities" bundle.
+	 *
+	 * Uses the Asset Manager's bundle support when this asset type is registered for scanning.
+	 * Otherwise, requests the bundle paths directly from the Streamable Manager.
+	 *
+	 * @param OnLoaded			Delegate invoked once all assets are loaded.
+	 * @return					Handle keeping the assets loaded. Null if the request could not be made.
+	 */
+	TSharedPtr<FStreamableHandle> LoadAbilityBundle(const FStreamableDelegate& OnLoaded = FStreamableDelegate()) const;
+
 };
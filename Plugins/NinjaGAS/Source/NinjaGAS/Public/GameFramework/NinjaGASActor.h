@@ -11,6 +11,11 @@ class UNinjaGASAbilitySystemComponent;
 
 /**
  * Base Actor class, with a pre-configured Ability System Component.
+ *
+ * When the lazy Ability System is enabled, the actor starts without an ASC. The authority creates
+ * and initializes one the first time it is requested, i.e. when an effect is applied or the ASC
+ * is queried through the Ability System Interface. Clients receive it through replication.
+ * Subclasses using this mode should skip the default subobject, as done by ANinjaGASLazyActor.
  */
 UCLASS(Abstract)
 class NINJAGAS_API ANinjaGASActor : public AActor, public IAbilitySystemInterface
@@ -27,6 +32,7 @@ public:
 
 	// -- Begin Actor implementation
 	virtual void PostInitProperties() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual void PreInitializeComponents() override;
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -36,6 +42,12 @@ public:
 	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 	// -- End Ability System implementation
 
+	/**
+	 * Checks if the Ability System Component exists, without creating it in lazy mode.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|Actor")
+	bool HasAbilitySystemComponent() const;
+
 protected:
 
 	/**
@@ -54,10 +66,33 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
 	EGameplayEffectReplicationMode AbilityReplicationMode;
 
+	/**
+	 * Creates the Ability System Component on first use, instead of when the actor is spawned.
+	 *
+	 * Only takes effect when the actor has no ASC, so the default subobject must be skipped.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System")
+	bool bEnableLazyAbilitySystem;
+
+	/** Ability System Component class created on first use, when the lazy Ability System is enabled. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ability System", meta = (EditCondition = "bEnableLazyAbilitySystem"))
+	TSubclassOf<UNinjaGASAbilitySystemComponent> LazyAbilitySystemClass;
+
+	/**
+	 * Creates, registers and initializes the Ability System Component. Authority only.
+	 */
+	virtual UNinjaGASAbilitySystemComponent* CreateLazyAbilitySystemComponent();
+
+	/**
+	 * Initializes the Ability System Component received by clients.
+	 */
+	UFUNCTION()
+	virtual void OnRep_ActorAbilities();
+	
 private:
 
 	/** The Ability System Component managed by this actor class. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess))
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, ReplicatedUsing = OnRep_ActorAbilities, Category = "Components", meta = (AllowPrivateAccess))
 	TObjectPtr<UNinjaGASAbilitySystemComponent> ActorAbilities;
 	
 };
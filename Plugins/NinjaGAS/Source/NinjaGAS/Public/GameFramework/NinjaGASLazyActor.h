@@ -0,0 +1,24 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/NinjaGASActor.h"
+#include "NinjaGASLazyActor.generated.h"
+
+/**
+ * Actor that only creates its Ability System Component when it is first needed.
+ *
+ * Meant for a large amount of actors, such as breakables and interactables, that
+ * rarely interact with the Ability System and should not pay for a replicated ASC.
+ */
+UCLASS(Abstract)
+class NINJAGAS_API ANinjaGASLazyActor : public ANinjaGASActor
+{
+	
+	GENERATED_BODY()
+
+public:
+
+	ANinjaGASLazyActor(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+	
+};
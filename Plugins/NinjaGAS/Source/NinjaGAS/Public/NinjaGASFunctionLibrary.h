@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "Abilities/GameplayAbilityTypes.h"
+#include "AbilitySystem/Types/FNinjaEffectBatchResult.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "NinjaGASFunctionLibrary.generated.h"
 
@@ -26,6 +27,35 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Ninja GAS", meta = (ReturnDisplayName = "ASC"))
 	static UNinjaGASAbilitySystemComponent* GetCustomAbilitySystemComponentFromActor(AActor* Owner);
+
+	/**
+	 * Provides the Ability System Component from an owner or avatar.
+	 * Uses the components registered in the Ninja GAS Subsystem, falling back to the Ability System Globals.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS", meta = (ReturnDisplayName = "ASC"))
+	static UAbilitySystemComponent* GetAbilitySystemComponentFromActor(const AActor* Actor);
+
+	/**
+	 * Provides the Ability System Components from multiple owners or avatars, such as targets hit by an area.
+	 *
+	 * @param Actors			Owners or avatars of the components.
+	 * @param OutComponents		Component for each actor, in the same order. Null if the actor has none.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS")
+	static void GetAbilitySystemComponentsFromActors(const TArray<AActor*>& Actors, TArray<UAbilitySystemComponent*>& OutComponents);
+
+	/**
+	 * Applies an outgoing Gameplay Effect spec to multiple targets, in a single batch.
+	 *
+	 * The spec must be created by a Ninja GAS Ability System Component, which applies it.
+	 *
+	 * @param SpecHandle		Outgoing spec shared by all targets.
+	 * @param Targets			Actors receiving the effect.
+	 * @param OutHandles		Handle for each target, in the same order.
+	 * @return					Summary of the batch, including its throughput.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS", meta = (ReturnDisplayName = "Result"))
+	static FNinjaEffectBatchResult ApplyGameplayEffectSpecToTargets(const FGameplayEffectSpecHandle& SpecHandle, const TArray<AActor*>& Targets, TArray<FActiveGameplayEffectHandle>& OutHandles);
 	
 	/**
 	 * Sends a Gameplay Event to the Owner's of an Ability System Component.
@@ -0,0 +1,7 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("NinjaGAS"), STATGROUP_NinjaGAS, STATCAT_Advanced);
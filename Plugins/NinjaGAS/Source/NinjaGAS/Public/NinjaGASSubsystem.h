@@ -2,9 +2,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AbilitySystem/Types/FNinjaAbilityDependencies.h"
+#include "AbilitySystem/Types/FNinjaAttributeInitializer.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "NinjaGASSubsystem.generated.h"
 
+class UAbilitySystemComponent;
+class UAttributeSet;
+class UDataTable;
+class UNinjaGASAbilitySystemComponent;
+class UNinjaGASDataAsset;
+struct FStreamableHandle;
+
 /**
  * Provides game instance-level functionalities for the Ability System.
  */
@@ -18,6 +28,137 @@ public:
 
 	// -- Begin Subsystem implementation
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 	// -- End Subsystem implementation
+
+	/**
+	 * Provides the compiled initializer for an Attribute Set class and attribute table.
+	 *
+	 * The initializer is compiled on first use and shared by every Attribute Set of the
+	 * same class initialized from the same table, for the lifetime of the game instance.
+	 *
+	 * @param AttributeSetClass		Attribute Set class being initialized. Must be valid.
+	 * @param AttributeTable		Table with the attribute values. Must be valid.
+	 * @return						Compiled initializer, ready to be applied.
+	 */
+	TSharedRef<const FNinjaAttributeInitializer> GetAttributeInitializer(const UClass* AttributeSetClass, const UDataTable* AttributeTable);
+
+	/**
+	 * Discards all compiled initializers created from a given attribute table.
+	 *
+	 * @param AttributeTable		Attribute table that changed.
+	 */
+	void InvalidateAttributeInitializers(const UDataTable* AttributeTable);
+
+	/**
+	 * Loads the "Abilities" bundle for ability setups that are about to be used.
+	 *
+	 * Meant to be called ahead of spawns, so avatars using these setups are initialized right away.
+	 * Assets are kept loaded until they are released or the game instance shuts down.
+	 *
+	 * @param AbilityData			Ability setups to preload.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|Subsystem")
+	void PreloadAbilityData(const TArray<UNinjaGASDataAsset*>& AbilityData);
+
+	/**
+	 * Releases ability setups previously preloaded.
+	 *
+	 * Assets are only unloaded once nothing else, such as an Ability System Component, references them.
+	 *
+	 * @param AbilityData			Ability setups to release.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|Subsystem")
+	void ReleasePreloadedAbilityData(const TArray<UNinjaGASDataAsset*>& AbilityData);
+	
+	/**
+	 * Provides all assets an ability class may load when activated.
+	 *
+	 * Collected once per class, on first use, from soft references in the ability defaults,
+	 * plus the Gameplay Cue Notifies for cues used by the ability and its effects.
+	 *
+	 * @param AbilityClass			Ability class to inspect. Must be valid.
+	 * @return						Asset and cue paths for the ability.
+	 */
+	const FNinjaAbilityDependencies& GetAbilityDependencies(const UClass* AbilityClass);
+
+	/**
+	 * Records how many dependencies of an ability were resident when it first activated.
+	 *
+	 * @param AbilityClass			Ability that activated.
+	 * @param ResidentCount			Dependencies already loaded.
+	 * @param TotalCount			All dependencies for the ability.
+	 */
+	void RecordAbilityFirstActivation(const UClass* AbilityClass, int32 ResidentCount, int32 TotalCount);
+
+	/**
+	 * Provides the aggregated preload results, for all first activations so far.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|Subsystem")
+	FNinjaAbilityPreloadStats GetAbilityPreloadStats() const;
+
+	/**
+	 * Registers an Ability System Component, so it can be found from its owner and avatar.
+	 *
+	 * Previous registrations for the same component are replaced, so this can be called
+	 * every time the actor info changes.
+	 *
+	 * @param AbilityComponent		Component being registered.
+	 * @param OwnerActor			Actor owning the component.
+	 * @param AvatarActor			Actor physically representing the component. Optional.
+	 */
+	void RegisterAbilitySystemComponent(UNinjaGASAbilitySystemComponent* AbilityComponent, const AActor* OwnerActor, const AActor* AvatarActor);
+
+	/**
+	 * Removes all registrations for an Ability System Component.
+	 *
+	 * @param AbilityComponent		Component being unregistered.
+	 */
+	void UnregisterAbilitySystemComponent(const UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Finds the Ability System Component registered for an actor, as its owner or avatar.
+	 *
+	 * @param Actor					Owner or avatar of the component.
+	 * @return						Registered component, or null if the actor has none.
+	 */
+	UNinjaGASAbilitySystemComponent* FindAbilitySystemComponent(const AActor* Actor) const;
+
+	/**
+	 * Finds the Ability System Components registered for multiple actors.
+	 *
+	 * @param Actors				Owners or avatars of the components.
+	 * @param OutComponents			Registered component for each actor, in the same order. Null if not found.
+	 */
+	void FindAbilitySystemComponents(const TArray<AActor*>& Actors, TArray<UNinjaGASAbilitySystemComponent*>& OutComponents) const;
+	
+private:
+
+	/** Registered Ability System Components, by owner and avatar. */
+	TMap<TObjectKey<AActor>, TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> AbilitySystemComponents;
+
+	/** Actors registered for each Ability System Component, so they can be removed together. */
+	TMap<TObjectKey<UNinjaGASAbilitySystemComponent>, TArray<TObjectKey<AActor>, TInlineAllocator<2>>> AbilitySystemComponentActors;
+
+	/** Dependencies collected for each ability class. */
+	TMap<TObjectKey<UClass>, FNinjaAbilityDependencies> AbilityDependencies;
+
+	/** Aggregated preload results. */
+	FNinjaAbilityPreloadStats AbilityPreloadStats;
+	
+	/** Handles keeping preloaded ability setups in memory. */
+	TMap<TObjectKey<UNinjaGASDataAsset>, TSharedPtr<FStreamableHandle>> PreloadedAbilityData;
+
+	using FAttributeInitializerKey = TPair<TObjectKey<UClass>, TObjectKey<UDataTable>>;
+	
+	/** Compiled attribute initializers, by Attribute Set class and attribute table. */
+	TMap<FAttributeInitializerKey, TSharedRef<const FNinjaAttributeInitializer>> AttributeInitializers;
+
+#if WITH_EDITOR
+	/** Attribute tables we are listening to, so compiled data is discarded when they are edited. */
+	TSet<TWeakObjectPtr<UDataTable>> ObservedAttributeTables;
+	
+	void HandleAttributeTableChanged(TWeakObjectPtr<UDataTable> AttributeTable);
+#endif
 	
 };
@@ -0,0 +1,369 @@
+﻿// Ninja Bear Studio Inc. 2024, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayCueInterface.h"
+#include "AbilitySystem/Types/FNinjaCueNotifyPool.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "NinjaGASWorldSubsystem.generated.h"
+
+class AGameplayCueNotify_Actor;
+class UNinjaGASAbilitySystemComponent;
+class UNinjaGASDataAsset;
+struct FStreamableHandle;
+
+/**
+ * Aggregated cost of the central Ability System tick, for the last frame.
+ */
+USTRUCT(BlueprintType)
+struct NINJAGAS_API FNinjaCentralTickStats
+{
+
+	GENERATED_BODY();
+
+	/** Ability System Components currently registered. */
+	UPROPERTY(BlueprintReadOnly, Category = "Central Tick Stats")
+	int32 RegisteredComponents = 0;
+
+	/** Ability System Components ticked in the last frame. */
+	UPROPERTY(BlueprintReadOnly, Category = "Central Tick Stats")
+	int32 TickedComponents = 0;
+
+	/** Time spent ticking all components in the last frame. */
+	UPROPERTY(BlueprintReadOnly, Category = "Central Tick Stats", meta = (Units = "ms"))
+	float TickTimeMs = 0.f;
+
+	/** Highest time spent ticking all components in a single frame. */
+	UPROPERTY(BlueprintReadOnly, Category = "Central Tick Stats", meta = (Units = "ms"))
+	float PeakTickTimeMs = 0.f;
+	
+};
+
+/**
+ * Provides world-level functionalities for the Ability System.
+ *
+ * Ticks all registered Ability System Components from a contiguous array, in a single tick
+ * function, instead of one component tick each. Each component has its own tick interval,
+ * either driven by its distance to the closest viewer, or set explicitly, such as from a
+ * significance manager. The aggregated cost is available via "stat NinjaGAS" and "GetCentralTickStats".
+ *
+ * Also hibernates components far from all viewers, and wakes them up once viewers get closer,
+ * and handles local gameplay cues queued by components, once per frame and within a budget.
+ * Replicated gameplay cues batched by components are sent at the end of the frame as well.
+ *
+ * Finally, prewarms and measures the pools of actor-based Gameplay Cue Notifies, when the
+ * Gameplay Cue Manager is a "UNinjaGASGameplayCueManager".
+ */
+UCLASS()
+class NINJAGAS_API UNinjaGASWorldSubsystem : public UTickableWorldSubsystem
+{
+	
+	GENERATED_BODY()
+
+public:
+
+	UNinjaGASWorldSubsystem();
+	
+	// -- Begin Subsystem implementation
+	virtual void Deinitialize() override;
+	// -- End Subsystem implementation
+
+	// -- Begin Tickable implementation
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	// -- End Tickable implementation
+
+	/**
+	 * Starts ticking an Ability System Component from this subsystem.
+	 *
+	 * @param AbilityComponent		Component to tick. Its own component tick should be disabled.
+	 */
+	void RegisterAbilitySystem(UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Stops ticking an Ability System Component from this subsystem.
+	 *
+	 * @param AbilityComponent		Component previously registered.
+	 */
+	void UnregisterAbilitySystem(const UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Checks if an Ability System Component is ticked by this subsystem.
+	 *
+	 * @param AbilityComponent		Component to check.
+	 * @return						True if the component is registered.
+	 */
+	bool IsAbilitySystemRegistered(const UNinjaGASAbilitySystemComponent* AbilityComponent) const;
+
+	/**
+	 * Starts evaluating hibernation for an Ability System Component, by its distance to the closest viewer.
+	 *
+	 * @param AbilityComponent		Component that can hibernate.
+	 */
+	void RegisterHibernationCandidate(UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Stops evaluating hibernation for an Ability System Component.
+	 *
+	 * @param AbilityComponent		Component previously registered.
+	 */
+	void UnregisterHibernationCandidate(const UNinjaGASAbilitySystemComponent* AbilityComponent);
+	
+	/**
+	 * Sets an explicit tick interval for a registered component, replacing its distance bands.
+	 *
+	 * Meant for external significance logic. A negative interval goes back to the distance bands.
+	 *
+	 * @param AbilityComponent		Component previously registered.
+	 * @param TickInterval			Seconds between ticks. Zero ticks every frame.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|World Subsystem")
+	void SetAbilitySystemTickInterval(const UNinjaGASAbilitySystemComponent* AbilityComponent, float TickInterval);
+
+	/**
+	 * Provides the distance from a location to the closest viewer, as of the last evaluation.
+	 *
+	 * Viewers are the pawns, or the view locations, from all player controllers in the world.
+	 *
+	 * @param Location				Location to check.
+	 * @return						Distance to the closest viewer, or the maximum float if there are none.
+	 */
+	float GetDistanceToClosestViewer(const FVector& Location) const;
+
+	/**
+	 * Queues a local gameplay cue, to be handled at the end of the frame.
+	 *
+	 * Identical cues for the same target are only handled once per frame, and an add and
+	 * a remove for the same cue and target, queued in the same frame, cancel each other out.
+	 *
+	 * @param Target				Actor receiving the cue.
+	 * @param GameplayCueTag		Gameplay Tag for the Gameplay Cue.
+	 * @param EventType				Executed, OnActive (also triggering WhileActive) or Removed.
+	 * @param Parameters			Parameters for the Gameplay Cue.
+	 */
+	void QueueLocalGameplayCue(AActor* Target, FGameplayTag GameplayCueTag, EGameplayCueEvent::Type EventType, const FGameplayCueParameters& Parameters);
+
+	/**
+	 * Queues an Ability System Component with replicated gameplay cues to send at the end of the frame.
+	 *
+	 * @param AbilityComponent		Component with a pending gameplay cue batch.
+	 */
+	void QueueGameplayCueBatch(UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Queues an Ability System Component with server RPC batches to close at the end of the frame.
+	 *
+	 * @param AbilityComponent		Component with abilities batched for the frame.
+	 */
+	void QueueAbilityRPCBatch(UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Queues an Ability System Component with a forced net update requested by montages.
+	 *
+	 * @param AbilityComponent		Component with a pending montage net update.
+	 */
+	void QueueMontageNetUpdate(UNinjaGASAbilitySystemComponent* AbilityComponent);
+
+	/**
+	 * Prewarms the cue notify pools configured in an ability setup.
+	 *
+	 * Classes are loaded asynchronously and instances are spawned over multiple frames. Each
+	 * pool is filled up to the largest size requested for its class. Ignored on dedicated servers.
+	 *
+	 * @param AbilityData			Ability setup with the cue notify pools.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Ninja GAS|World Subsystem")
+	void PrewarmCueNotifyPools(const UNinjaGASDataAsset* AbilityData);
+
+	/**
+	 * Checks if a cue notify class has a pool configured.
+	 *
+	 * @param NotifyClass			Cue notify actor class to check.
+	 * @return						True if any ability setup requested a pool for the class.
+	 */
+	bool IsCueNotifyClassPooled(const UClass* NotifyClass) const;
+
+	/**
+	 * Records a request for a cue notify actor.
+	 *
+	 * @param NotifyClass			Cue notify actor class requested.
+	 * @param bHit					True if served by a pooled instance, false if a new instance was spawned.
+	 */
+	void RecordCueNotifyRequest(const UClass* NotifyClass, bool bHit);
+
+	/**
+	 * Records a cue notify actor that finished.
+	 *
+	 * @param NotifyClass			Cue notify actor class that finished.
+	 * @param bRecycled				True if returned to the pool, false if destroyed.
+	 */
+	void RecordCueNotifyFinished(const UClass* NotifyClass, bool bRecycled);
+
+	/**
+	 * Provides the pool statistics for a cue notify class.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|World Subsystem")
+	FNinjaCueNotifyPoolStats GetCueNotifyPoolStats(TSubclassOf<AGameplayCueNotify_Actor> NotifyClass) const;
+
+	/**
+	 * Provides the pool statistics for all cue notify classes.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|World Subsystem")
+	FNinjaCueNotifyPoolStats GetCueNotifyPoolTotals() const;
+
+	/**
+	 * Provides the distance from an Ability System Component's avatar, or owner, to the closest viewer.
+	 *
+	 * @param AbilityComponent		Component to check.
+	 * @return						Distance to the closest viewer, or the maximum float if unknown.
+	 */
+	float GetDistanceToClosestViewer(const UNinjaGASAbilitySystemComponent* AbilityComponent) const;
+	
+	/**
+	 * Provides the aggregated cost of the central tick.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja GAS|World Subsystem")
+	FNinjaCentralTickStats GetCentralTickStats() const;
+
+protected:
+
+	// -- Begin Subsystem implementation
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	// -- End Subsystem implementation
+	
+private:
+
+	/** Local gameplay cue waiting to be handled. */
+	struct FQueuedGameplayCue
+	{
+		/** Actor receiving the cue. */
+		TWeakObjectPtr<AActor> Target;
+
+		/** Gameplay Tag for the Gameplay Cue. */
+		FGameplayTag GameplayCueTag;
+
+		/** Executed, OnActive or Removed. */
+		EGameplayCueEvent::Type EventType = EGameplayCueEvent::Executed;
+
+		/** Parameters for the Gameplay Cue. */
+		FGameplayCueParameters Parameters;
+
+		/** Set when a matching add or remove cancelled this cue. */
+		bool bCancelled = false;
+	};
+
+	/** Identifies a cue for a target. Adds and removes share a key, executions have their own. */
+	using FQueuedGameplayCueKey = TTuple<TObjectKey<AActor>, FGameplayTag, bool>;
+	
+	/** Local gameplay cues waiting to be handled, in the order they were queued. */
+	TArray<FQueuedGameplayCue> QueuedGameplayCues;
+
+	/** Position of each cue queued in this frame, used to merge duplicates and cancellations. */
+	TMap<FQueuedGameplayCueKey, int32> QueuedGameplayCueIndices;
+	
+	/** Components with gameplay cue batches to send. */
+	TArray<TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> PendingGameplayCueBatches;
+	
+	/** Components with server RPC batches open for the frame. */
+	TArray<TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> PendingAbilityRPCBatches;
+	
+	/** Components with forced net updates requested by montages. */
+	TArray<TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> PendingMontageNetUpdates;
+	
+	/** Largest pool size requested for each cue notify class. */
+	TMap<TObjectKey<UClass>, int32> CueNotifyPoolSizes;
+
+	/** Cue notify classes that may still be below their pool size. */
+	TArray<TWeakObjectPtr<UClass>> PendingCueNotifyPools;
+
+	/** Handles keeping pooled cue notify classes loaded. */
+	TArray<TSharedPtr<FStreamableHandle>> CueNotifyPoolHandles;
+
+	/** Pool statistics, by cue notify class. */
+	TMap<TObjectKey<UClass>, FNinjaCueNotifyPoolStats> CueNotifyPoolStats;
+	
+	/** Tick state for a registered component. */
+	struct FTickEntry
+	{
+		/** Component being ticked. */
+		TWeakObjectPtr<UNinjaGASAbilitySystemComponent> AbilityComponent;
+
+		/** Key for the component, still usable once the component is gone. */
+		TObjectKey<UNinjaGASAbilitySystemComponent> AbilityComponentKey;
+
+		/** Seconds between ticks. */
+		float TickInterval = 0.f;
+
+		/** Seconds since the last tick. */
+		float AccumulatedTime = 0.f;
+
+		/** Set when the interval was provided explicitly, ignoring the distance bands. */
+		bool bExplicitInterval = false;
+
+		/** Set when the entry was removed while ticking, so it is only compacted afterwards. */
+		bool bPendingRemoval = false;
+	};
+
+	/** All registered components, ticked in order. */
+	TArray<FTickEntry> TickEntries;
+
+	/** Position of each registered component in the tick entries. */
+	TMap<TObjectKey<UNinjaGASAbilitySystemComponent>, int32> TickEntryIndices;
+
+	/** Components that may hibernate, evaluated along with the tick intervals. */
+	TArray<TWeakObjectPtr<UNinjaGASAbilitySystemComponent>> HibernationCandidates;
+	
+	/** Viewer locations, collected in the last evaluation. */
+	TArray<FVector> ViewerLocations;
+	
+	/** Seconds until distance-driven intervals are evaluated again. */
+	float SignificanceRefreshCountdown;
+
+	/** Set while registered components are ticked, deferring the removal of tick entries. */
+	bool bTickingAbilitySystems;
+
+	/** Set when tick entries were removed while ticking and must be compacted. */
+	bool bHasPendingTickEntryRemovals;
+
+	/** Aggregated cost of the central tick. */
+	FNinjaCentralTickStats CentralTickStats;
+
+	/** Ticks all registered components that are due. */
+	void TickAbilitySystems(float DeltaTime);
+
+	/** Closes all server RPC batches opened in this frame. */
+	void FlushAbilityRPCBatches();
+
+	/** Forces pending montage net updates, keeping the ones still within their minimum interval. */
+	void FlushMontageNetUpdates();
+	
+	/** Sends all pending gameplay cue batches. */
+	void FlushGameplayCueBatches();
+	
+	/** Requests pool sizes for loaded cue notify classes. */
+	void AddCueNotifyPools(const TArray<FNinjaCueNotifyPool>& CueNotifyPools);
+
+	/** Spawns pooled instances for classes below their pool size, within the per-frame budget. */
+	void PrewarmPendingCueNotifyPools();
+	
+	/** Handles queued local gameplay cues, within the per-frame budget. */
+	void FlushLocalGameplayCues();
+	
+	/** Collects the current viewer locations. */
+	void RefreshViewerLocations();
+
+	/** Hibernates or wakes candidates, from their distance to the closest viewer. */
+	void RefreshHibernation();
+	
+	/** Evaluates the tick interval for an entry, from its component's distance bands. */
+	void RefreshTickInterval(FTickEntry& Entry) const;
+	
+	/** Removes an entry, moving the last entry into its place. Deferred while ticking. */
+	void RemoveTickEntryAt(int32 Index);
+
+	/** Removes all entries marked for removal while ticking. */
+	void CompactTickEntries();
+	
+};
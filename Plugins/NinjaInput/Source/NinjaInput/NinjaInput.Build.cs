@@ -23,7 +23,8 @@ public class NinjaInput : ModuleRules
 			"EnhancedInput",
 			"GameplayAbilities",
 			"GameplayTags",
-			"GameplayTasks"
+			"GameplayTasks",
+			"NinjaGAS"
 		});
 		
 		PrivateDependencyModuleNames.AddRange(new [] 
@@ -25,8 +25,7 @@ bool UInputHandler_AbilityClass::HasActiveAbility(UNinjaInputManagerComponent* M
     if (ensureMsgf(IsValid(AbilitySystemComponent), TEXT("No ASC received from the Input Manager.")) &&
         ensureMsgf(IsValid(AbilityClass), TEXT("The Gameplay Ability Class must be valid.")))
     {
-        const FGameplayAbilitySpec* Spec = AbilitySystemComponent->FindAbilitySpecFromClass(AbilityClass);
-        return Spec != nullptr && Spec->Handle.IsValid() && Spec->IsActive();
+        return FNinjaInputHandlerHelpers::IsAbilityClassActive(AbilitySystemComponent, AbilityClass);
     }
 
     return false;
@@ -41,6 +40,7 @@ void UInputHandler_AbilityClass::ActivateAbility(UNinjaInputManagerComponent* Ma
         UE_LOG(LogNinjaInputHandler, Verbose, TEXT("[%s] Action %s is triggering ability with class %s."),
             *GetNameSafe(Manager->GetOwner()), *GetNameSafe(InputAction), *GetNameSafe(AbilityClass));
 
+        FNinjaInputHandlerHelpers::BatchAbilityRPCsByClass(AbilitySystemComponent, AbilityClass);
         AbilitySystemComponent->TryActivateAbilityByClass(AbilityClass);
     }
 }
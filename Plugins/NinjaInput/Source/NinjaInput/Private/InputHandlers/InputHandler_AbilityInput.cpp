@@ -24,16 +24,7 @@ bool UInputHandler_AbilityInput::HasActiveAbility(UNinjaInputManagerComponent* M
     if (ensureMsgf(IsValid(AbilitySystemComponent), TEXT("No ASC received from the Input Manager.")) &&
         ensureMsgf(InputID > INDEX_NONE, TEXT("The Input ID must be equal or greater than zero.")))
     {
-        TArray<const FGameplayAbilitySpec*> Specs;
-        AbilitySystemComponent->FindAllAbilitySpecsFromInputID(InputID, Specs);
-
-        for (const FGameplayAbilitySpec* Spec : Specs)
-        {
-            if (Spec != nullptr && Spec->Handle.IsValid() && Spec->IsActive())
-            {
-                return true;
-            }
-        }
+        return FNinjaInputHandlerHelpers::HasActiveAbilityWithInputID(AbilitySystemComponent, InputID);
     }
 
     return false;
@@ -48,6 +39,7 @@ void UInputHandler_AbilityInput::ActivateAbility(UNinjaInputManagerComponent* Ma
         UE_LOG(LogNinjaInputHandler, Verbose, TEXT("[%s] Action %s is triggering an ability with ID %d."),
                 *GetNameSafe(Manager->GetOwner()), *GetNameSafe(InputAction), InputID);
 
+        FNinjaInputHandlerHelpers::BatchAbilityRPCsByInputID(AbilitySystemComponent, InputID);
         AbilitySystemComponent->AbilityLocalInputPressed(InputID);
     }
 }
@@ -25,17 +25,7 @@ bool UInputHandler_AbilityTag::HasActiveAbility(UNinjaInputManagerComponent* Man
     if (ensureMsgf(IsValid(AbilitySystemComponent), TEXT("No ASC received from the Input Manager.")) &&
         ensureMsgf(AbilityTags.IsValid(), TEXT("The Gameplay Tag Container must be valid.")))
     {
-        TArray<FGameplayAbilitySpecHandle> Handles;
-        AbilitySystemComponent->FindAllAbilitiesWithTags(Handles, AbilityTags);
-
-        for (const FGameplayAbilitySpecHandle& Handle : Handles)
-        {
-            const FGameplayAbilitySpec* Spec = AbilitySystemComponent->FindAbilitySpecFromHandle(Handle);
-            if (Spec != nullptr && Spec->Handle.IsValid() && Spec->IsActive())
-            {
-                return true;      
-            }
-        }
+        return FNinjaInputHandlerHelpers::HasActiveAbilityWithTags(AbilitySystemComponent, AbilityTags);
     }
 
     return false;
@@ -50,6 +40,7 @@ void UInputHandler_AbilityTag::ActivateAbility(UNinjaInputManagerComponent* Mana
         UE_LOG(LogNinjaInputHandler, Verbose, TEXT("[%s] Action %s is triggering abilities with tags %s."),
             *GetNameSafe(Manager->GetOwner()), *GetNameSafe(InputAction), *AbilityTags.ToStringSimple());
 
+        FNinjaInputHandlerHelpers::BatchAbilityRPCsByTags(AbilitySystemComponent, AbilityTags);
         AbilitySystemComponent->TryActivateAbilitiesByTag(AbilityTags);
     }
 }
@@ -17,7 +17,7 @@ void UInputHandler_HUDEvent::HandleTriggeredEvent_Implementation(UNinjaInputMana
 {
 	if (ensure(EventTag.IsValid()))
 	{
-		const APlayerController* PlayerController = Cast<APlayerController>(Manager->GetController());
+		const APlayerController* PlayerController = Manager->GetPlayerController();
 		if (IsValid(PlayerController))
 		{
 			AHUD* HUD = PlayerController->GetHUD();
@@ -1,11 +1,11 @@
 ﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
 #include "NinjaInputManagerComponent.h"
 
-#include "AbilitySystemGlobals.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputAction.h"
 #include "InputMappingContext.h"
+#include "NinjaGASFunctionLibrary.h"
 #include "NinjaInputHandler.h"
 #include "NinjaInputHandlerHelpers.h"
 #include "NinjaInputSettings.h"
@@ -13,20 +13,53 @@
 #include "Data/NinjaInputSetupDataAsset.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
+#include "EngineUtils.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/PawnMovementComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/PlayerState.h"
+#include "Async/Async.h"
 #include "Interfaces/LastInputProviderInterface.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 
 DEFINE_LOG_CATEGORY(LogNinjaInputManagerComponent);
 
 FName UNinjaInputManagerComponent::ForwardReferenceTag = TEXT("InputForwardReference");
 
+static FAutoConsoleCommandWithWorldAndArgs DumpInputHistoryCommand(
+    TEXT("ninjainput.DumpInputHistory"),
+    TEXT("Dumps the server-side Input History for all Input Managers recording it. Optional argument: reason."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, const UWorld* World)
+    {
+        if (!IsValid(World) || World->GetNetMode() == NM_Client)
+        {
+            return;
+        }
+
+        const FString Reason = Args.IsEmpty() ? TEXT("Manual") : Args[0];
+        for (TActorIterator<AActor> It(World); It; ++It)
+        {
+            TInlineComponentArray<UNinjaInputManagerComponent*> Managers(*It);
+            for (const UNinjaInputManagerComponent* Manager : Managers)
+            {
+                Manager->DumpInputHistory(Reason);
+            }
+        }
+    }));
+
 UNinjaInputManagerComponent::UNinjaInputManagerComponent()
 {
     SetIsReplicatedByDefault(true);
+
+    bRecordInputHistory = false;
+    InputHistoryDuration = 10.f;
+    InputHistoryEventsPerSecond = 30;
+    InputHistoryDumpInterval = 10.f;
+    LastInputHistoryDumpTime = -UE_BIG_NUMBER;
+    InputHistoryDumpCount = 0;
+    bInputActive = false;
 }
 
 // Initialization and Shutdown ------------------------------------------------
@@ -38,20 +71,30 @@ void UNinjaInputManagerComponent::OnRegister()
 	const UWorld* World = GetWorld();
 	if (IsValid(World) && World->IsGameWorld())
 	{
-		APawn* OwnerPawn = Cast<APawn>(GetOwner());
-		if (IsValid(OwnerPawn))
+		RefreshOwnerCache();
+		
+		APawn* PawnOwner = Cast<APawn>(GetOwner());
+		if (IsValid(PawnOwner))
 		{
-			OwnerPawn->ReceiveRestartedDelegate.AddDynamic(this, &ThisClass::OnPawnRestarted);
-			OwnerPawn->ReceiveControllerChangedDelegate.AddDynamic(this, &ThisClass::OnControllerChanged);
+			PawnOwner->ReceiveRestartedDelegate.AddDynamic(this, &ThisClass::OnPawnRestarted);
+			PawnOwner->ReceiveControllerChangedDelegate.AddDynamic(this, &ThisClass::OnControllerChanged);
 
-			if (IsValid(OwnerPawn->InputComponent))
+			if (IsValid(PawnOwner->InputComponent))
 			{
 				// If our pawn already has an Input Component, then this means this component
 				// was added/registered after a pawn restart. So we need to initialize it right away!
 				
-				OnPawnRestarted(OwnerPawn);
+				OnPawnRestarted(PawnOwner);
 			}
 		}
+		else if (AController* ControllerOwner = Cast<AController>(GetOwner()))
+		{
+			ControllerOwner->OnPossessedPawnChanged.AddDynamic(this, &ThisClass::OnPossessedPawnChanged);
+		}
+		else if (APlayerState* PlayerStateOwner = Cast<APlayerState>(GetOwner()))
+		{
+			PlayerStateOwner->OnPawnSet.AddDynamic(this, &ThisClass::OnPlayerStatePawnSet);
+		}
 	}
 }
 
@@ -59,12 +102,23 @@ void UNinjaInputManagerComponent::OnRegister()
 void UNinjaInputManagerComponent::OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
 {
     // Only handle releasing the controller as "OnPawnRestarted" will re-run the setup.
-    if (ensure(IsValid(Pawn) && Pawn == GetOwner()) && OldController)
+    if (ensure(IsValid(Pawn) && Pawn == GetOwner()))
     {
-        ClearInputSetup();
+        if (OldController)
+        {
+            ClearInputSetup();
+        }
 
         if (IsValid(NewController)) { OwnerController = NewController; }
         else { OwnerController = nullptr; }
+        OwnerPlayerController = Cast<APlayerController>(OwnerController);
+
+        UpdateReplicationState(Pawn);
+        
+        if (!Pawn->IsLocallyControlled())
+        {
+            EnterDormancy();
+        }
     }
 }
 // ReSharper restore CppParameterMayBeConstPtrOrRef
@@ -74,11 +128,17 @@ void UNinjaInputManagerComponent::OnPawnRestarted(APawn* Pawn)
 {
     if (ensure(Pawn && Pawn == GetPawn()) && Pawn->InputComponent)
     {
-        if (Pawn->InputComponent)
+        UpdateReplicationState(Pawn);
+        
+        if (!Pawn->IsLocallyControlled())
         {
-            OwnerController = Pawn->GetController();
-            SetupInputComponent(Pawn);
+            // Pawns that are not locally controlled will never receive input from this machine.
+            EnterDormancy();
+            return;
         }
+        
+        RefreshOwnerCache();
+        SetupInputComponent(Pawn);
 
         const TArray<UActorComponent*> ForwardReferences = GetOwner()->GetComponentsByTag(UArrowComponent::StaticClass(), ForwardReferenceTag);
         ForwardReference = ForwardReferences.Num() > 0 ? Cast<UArrowComponent>(ForwardReferences[0]) : nullptr;
@@ -91,16 +151,45 @@ void UNinjaInputManagerComponent::OnPawnRestarted(APawn* Pawn)
 }
 // ReSharper restore CppParameterMayBeConstPtrOrRef
 
+// ReSharper disable CppParameterMayBeConstPtrOrRef
+void UNinjaInputManagerComponent::OnPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn)
+{
+    RefreshOwnerCache();
+}
+// ReSharper restore CppParameterMayBeConstPtrOrRef
+
+// ReSharper disable CppParameterMayBeConstPtrOrRef
+void UNinjaInputManagerComponent::OnPlayerStatePawnSet(APlayerState* PlayerState, APawn* NewPawn, APawn* OldPawn)
+{
+    RefreshOwnerCache();
+}
+// ReSharper restore CppParameterMayBeConstPtrOrRef
+
+void UNinjaInputManagerComponent::RefreshOwnerCache()
+{
+    OwnerPawn = ResolvePawn();
+    OwnerController = ResolveController();
+    OwnerPlayerController = Cast<APlayerController>(OwnerController);
+}
+
 void UNinjaInputManagerComponent::OnUnregister()
 {
     const TObjectPtr<UWorld> World = GetWorld();
     if (IsValid(World) && World->IsGameWorld())
     {
-        APawn* OwnerPawn = Cast<APawn>(GetOwner());
-        if (IsValid(OwnerPawn))
+        APawn* PawnOwner = Cast<APawn>(GetOwner());
+        if (IsValid(PawnOwner))
+        {
+            PawnOwner->ReceiveRestartedDelegate.RemoveAll(this);
+            PawnOwner->ReceiveControllerChangedDelegate.RemoveAll(this);
+        }
+        else if (AController* ControllerOwner = Cast<AController>(GetOwner()))
         {
-            OwnerPawn->ReceiveRestartedDelegate.RemoveAll(this);
-            OwnerPawn->ReceiveControllerChangedDelegate.RemoveAll(this);
+            ControllerOwner->OnPossessedPawnChanged.RemoveAll(this);
+        }
+        else if (APlayerState* PlayerStateOwner = Cast<APlayerState>(GetOwner()))
+        {
+            PlayerStateOwner->OnPawnSet.RemoveAll(this);
         }
     }
 
@@ -109,6 +198,21 @@ void UNinjaInputManagerComponent::OnUnregister()
     Super::OnUnregister();
 }
 
+void UNinjaInputManagerComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (bRecordInputHistory && GetOwner()->HasAuthority())
+    {
+        // All memory used by the history is allocated here, so recording never allocates.
+        const int32 Capacity = FMath::CeilToInt32(InputHistoryDuration * InputHistoryEventsPerSecond);
+        InputHistory.Initialize(Capacity);
+
+        UE_LOG(LogNinjaInputManagerComponent, Log, TEXT("[%s] Recording Input History with %d entries (%d bytes)."),
+            *GetNameSafe(GetOwner()), Capacity, Capacity * static_cast<int32>(sizeof(FInputHistoryRecord)));
+    }
+}
+
 void UNinjaInputManagerComponent::SetupInputComponent(const APawn* Pawn)
 {
 	InputComponent = Cast<UEnhancedInputComponent>(Pawn->InputComponent);
@@ -116,6 +220,7 @@ void UNinjaInputManagerComponent::SetupInputComponent(const APawn* Pawn)
 	{
 		if (IsValid(OwnerController))
 		{
+		    bInputActive = true;
 		    for (const TObjectPtr<const UNinjaInputSetupDataAsset> SetupData : InputHandlerSetup)
 		    {
 		        AddInputSetupData(SetupData);
@@ -124,6 +229,41 @@ void UNinjaInputManagerComponent::SetupInputComponent(const APawn* Pawn)
 	}
 }
 
+void UNinjaInputManagerComponent::EnterDormancy()
+{
+    if (bInputActive || !ProcessedSetups.IsEmpty())
+    {
+        UE_LOG(LogNinjaInputManagerComponent, Verbose, TEXT("[%s] Input Manager is now dormant."), *GetNameSafe(GetOwner()));
+    }
+    
+    ClearInputSetup();
+    BufferedCommands.Reset();
+    
+    InputComponent = nullptr;
+    bInputActive = false;
+}
+
+void UNinjaInputManagerComponent::UpdateReplicationState(const APawn* Pawn)
+{
+    if (IsValid(Pawn) && Pawn->HasAuthority())
+    {
+        const bool bPlayerControlled = Pawn->GetController() && Pawn->GetController()->IsA<APlayerController>();
+        if (GetIsReplicated() != bPlayerControlled)
+        {
+            SetIsReplicated(bPlayerControlled);
+        }
+    }
+}
+
+void UNinjaInputManagerComponent::OpenInputBuffer_Implementation()
+{
+    // Dormant managers never dispatch, so there's nothing to be buffered.
+    if (bInputActive)
+    {
+        Super::OpenInputBuffer_Implementation();
+    }
+}
+
 // Core Functionality -------------------------------------------------------------------
 
 void UNinjaInputManagerComponent::AddInputSetupData(const UNinjaInputSetupDataAsset* SetupData)
@@ -275,7 +415,8 @@ void UNinjaInputManagerComponent::Dispatch(const FInputActionInstance& ActionIns
 
     for (auto It(ProcessedSetups.CreateConstIterator()); It; ++It)
     {
-        for (TObjectPtr<UNinjaInputHandler> Handler : ProcessedSetups.Find(It.Key())->SourceData->InputHandlers)
+        const UNinjaInputSetupDataAsset* SourceData = It.Value().SourceData;
+        for (TObjectPtr<UNinjaInputHandler> Handler : SourceData->InputHandlers)
         {
             if (IsValid(Handler) && Handler->CanHandle(ActualTrigger, InputAction))
             {
@@ -284,7 +425,7 @@ void UNinjaInputManagerComponent::Dispatch(const FInputActionInstance& ActionIns
                     UE_LOG(LogNinjaInputManagerComponent, VeryVerbose, TEXT("[%s] Input Action %s will be saved as an Input Buffer candidate."),
                         *GetNameSafe(GetOwner()), *GetNameSafe(InputAction));
                 
-                    FBufferedInputCommand NewCommand(this, InputAction, Handler, Value, ActualTrigger);
+                    FBufferedInputCommand NewCommand(this, InputAction, Handler, Value, ActualTrigger, SourceData);
                     CandidateCommands.AddUnique(NewCommand);
                 }
                 else
@@ -304,18 +445,34 @@ void UNinjaInputManagerComponent::Dispatch(const FInputActionInstance& ActionIns
 
 void UNinjaInputManagerComponent::ClearInputSetup()
 {
-    // Iterate on the keys instead of the map directly, as each removal function invoked will modify it.
-    TArray<TObjectPtr<UInputMappingContext>> Keys;
-    ProcessedSetups.GetKeys(Keys);
+    if (ProcessedSetups.IsEmpty())
+    {
+        return;
+    }
+    
+    // Every command we buffered comes from one of our setups, so they can all go in a single pass.
+    BufferedCommands.RemoveAll([this](const FBufferedInputCommand& Command) { return Command.Source == this; });
+
+    // All bindings created by this manager are bound to it, so they can be released in bulk.
+    // Deliberately not using "IsValid()", as it may have GC flags if we're in the "EndPlay" flow.
+    if (InputComponent)
+    {
+        InputComponent->ClearBindingsForObject(this);
+    }
 
-    for (TObjectPtr<UInputMappingContext> Key : Keys)
+    const TObjectPtr<UEnhancedInputLocalPlayerSubsystem> Subsystem = GetEnhancedInputSubsystem(OwnerController.Get());
+    if (IsValid(Subsystem))
     {
-        // Avoid race conditions of the controller being changed/gone and the component is already shutting down.
-        if (ProcessedSetups.Contains(Key))
+        for (auto It(ProcessedSetups.CreateConstIterator()); It; ++It)
         {
-            RemoveInputSetupData(ProcessedSetups[Key].SourceData);
+            Subsystem->RemoveMappingContext(It.Key());
         }
     }
+
+    UE_LOG(LogNinjaInputManagerComponent, Log, TEXT("[%s] Cleared %d Input Contexts."),
+        *GetNameSafe(GetOwner()), ProcessedSetups.Num());
+    
+    ProcessedSetups.Reset();
 }
 
 void UNinjaInputManagerComponent::RemoveInputSetupData(const UNinjaInputSetupDataAsset* SetupData)
@@ -323,11 +480,8 @@ void UNinjaInputManagerComponent::RemoveInputSetupData(const UNinjaInputSetupDat
     if (ensure(IsValid(SetupData)) && HasSetupData(SetupData))
     {
         // Make sure the buffered handlers from this setup won't be executed later.
-        for (TObjectPtr<UNinjaInputHandler> Handler : SetupData->InputHandlers)
-        {
-            BufferedCommands.RemoveAll([Handler](const FBufferedInputCommand& Command)
-                { return Command.Handler == Handler; });
-        }
+        BufferedCommands.RemoveAll([SetupData](const FBufferedInputCommand& Command)
+            { return Command.SourceSetup == SetupData; });
         
         RemoveInputMappingContext(SetupData->InputMappingContext);
     }
@@ -339,18 +493,31 @@ void UNinjaInputManagerComponent::RemoveInputMappingContext(const UInputMappingC
     {
         if (ProcessedSetups.Contains(InputMappingContext))
         {
-            FProcessedInputSetup Setup = ProcessedSetups.FindAndRemoveChecked(InputMappingContext);
-            for (auto It = Setup.ProcessedBindings.CreateIterator(); It; ++It)
+            const FProcessedInputSetup Setup = ProcessedSetups.FindAndRemoveChecked(InputMappingContext);
+            
+            // Deliberately not using "IsValid()", as it may have GC flags if we're in the "EndPlay" flow.
+            if (InputComponent && !Setup.ProcessedBindings.IsEmpty())
             {
-                // Deliberately not using "IsValid()", as it may have GC flags if we're in the "EndPlay" flow.
-                if (InputComponent)
+                TSet<uint32> Handles;
+                Handles.Reserve(Setup.ProcessedBindings.Num());
+                
+                for (const FProcessedBinding& Binding : Setup.ProcessedBindings)
                 {
-                    const FProcessedBinding Binding = *It;
-                    InputComponent->RemoveBinding(*Binding.Handle);
+                    if (Binding.Handle != nullptr)
+                    {
+                        Handles.Add(Binding.Handle->GetHandle());
+                    }
+                }
+
+                // A single reverse sweep over the component's bindings, instead of one search per binding.
+                const TArray<TUniquePtr<FEnhancedInputActionEventBinding>>& EventBindings = InputComponent->GetActionEventBindings();
+                for (int32 Index = EventBindings.Num() - 1; Index >= 0 && !Handles.IsEmpty(); --Index)
+                {
+                    if (Handles.Remove(EventBindings[Index]->GetHandle()) > 0)
+                    {
+                        InputComponent->RemoveActionEventBinding(Index);
+                    }
                 }
-                
-                // We still want to remove this entry, regardless of the Input Component being available or not.
-                It.RemoveCurrent();
             }
         }
 
@@ -367,14 +534,14 @@ void UNinjaInputManagerComponent::RemoveInputMappingContext(const UInputMappingC
 
 UAbilitySystemComponent* UNinjaInputManagerComponent::GetAbilitySystemComponent() const
 {
-    return UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(GetOwner());
+    return UNinjaGASFunctionLibrary::GetAbilitySystemComponentFromActor(GetOwner());
 }
 
 int32 UNinjaInputManagerComponent::SendGameplayEventToOwner(const FGameplayTag& GameplayEventTag,
     const FInputActionValue& Value, const UInputAction* InputAction, const bool bSendLocally, bool const bSendToServer) const
 {
     int32 Activations = 0;
-    const TObjectPtr<APlayerController> PlayerController = Cast<APlayerController>(GetController());
+    const TObjectPtr<APlayerController> PlayerController = GetPlayerController();
     
     if (IsValid(PlayerController) && ensureMsgf(GameplayEventTag.IsValid(), TEXT("The Gameplay Event Tag must be valid.")))
     {
@@ -410,10 +577,57 @@ void UNinjaInputManagerComponent::Client_SendGameplayEventToOwner_Implementation
 void UNinjaInputManagerComponent::Server_SendGameplayEventToOwner_Implementation(const FGameplayTag& GameplayEventTag,
     const FInputActionValue& Value, const UInputAction* InputAction) const
 {
+    if (InputHistory.IsInitialized())
+    {
+        InputHistory.Record(static_cast<uint32>(GFrameCounter), GetWorld()->GetTimeSeconds(), GameplayEventTag, Value.GetMagnitude(), InputAction);
+        // The tag comes from the client, so dumps are rate limited to keep disk writes bounded.
+        const double ServerTime = GetWorld()->GetTimeSeconds();
+        if (InputHistoryDumpTags.HasTag(GameplayEventTag) && ServerTime - LastInputHistoryDumpTime >= InputHistoryDumpInterval)
+        {
+            LastInputHistoryDumpTime = ServerTime;
+            DumpInputHistory(GameplayEventTag.ToString());
+        }
+    }
+    
     const FString Context = "Server RPC";
     FNinjaInputHandlerHelpers::SendGameplayEvent(this, GameplayEventTag, Value, InputAction, Context);
 }
 
+FString UNinjaInputManagerComponent::DumpInputHistory(const FString& Reason) const
+{
+    if (!InputHistory.IsInitialized() || InputHistory.Num() == 0)
+    {
+        return FString();
+    }
+
+    const float MinServerTime = GetWorld()->GetTimeSeconds() - InputHistoryDuration;
+    
+    TArray<uint8> Data;
+    const int32 Records = InputHistory.Serialize(MinServerTime, Data);
+
+    // Frame and counter keep dumps requested within the same second from overwriting each other.
+    const FString OwnerName = GetNameSafe(GetOwner());
+    const FString FileName = FPaths::MakeValidFileName(FString::Printf(TEXT("%s-%s-%s-%llu-%d.nih"),
+        *OwnerName, *Reason, *FDateTime::Now().ToString(), GFrameCounter, InputHistoryDumpCount++));
+    
+    const FString FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputHistory"), FileName);
+    AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Data = MoveTemp(Data), FilePath, OwnerName, Records]()
+    {
+        if (!FFileHelper::SaveArrayToFile(Data, *FilePath))
+        {
+            UE_LOG(LogNinjaInputManagerComponent, Warning, TEXT("[%s] Unable to write the Input History to %s."),
+                *OwnerName, *FilePath);
+            
+            return;
+        }
+
+        UE_LOG(LogNinjaInputManagerComponent, Log, TEXT("[%s] Dumped %d Input History records to %s."),
+            *OwnerName, Records, *FilePath);
+    });
+    
+    return FilePath;
+}
+
 // Support and Getter Functions ---------------------------------------------------------
 
 bool UNinjaInputManagerComponent::HasSetupData(const UNinjaInputSetupDataAsset* SetupData) const
@@ -533,6 +747,40 @@ FVector UNinjaInputManagerComponent::GetLastInputVector() const
 }
 
 APawn* UNinjaInputManagerComponent::GetPawn() const
+{
+	if (IsValid(OwnerPawn))
+	{
+		return OwnerPawn;
+	}
+	
+	APawn* Pawn = ResolvePawn();
+	ensureAlwaysMsgf(IsValid(Pawn), TEXT("Unable to retrieve the owning Pawn."));
+	return Pawn;
+}
+
+AController* UNinjaInputManagerComponent::GetController() const
+{
+	if (IsValid(OwnerController))
+	{
+		return OwnerController;
+	}
+	
+	AController* Controller = ResolveController();
+	ensureAlwaysMsgf(IsValid(Controller), TEXT("Unable to retrieve the owning Controller."));
+	return Controller;
+}
+
+APlayerController* UNinjaInputManagerComponent::GetPlayerController() const
+{
+	if (IsValid(OwnerPlayerController))
+	{
+		return OwnerPlayerController;
+	}
+
+	return Cast<APlayerController>(ResolveController());
+}
+
+APawn* UNinjaInputManagerComponent::ResolvePawn() const
 {
 	TObjectPtr<APawn> Pawn = nullptr;
 	
@@ -551,11 +799,10 @@ APawn* UNinjaInputManagerComponent::GetPawn() const
 		Pawn = PlayerState->GetPawn();
 	}
 
-	ensureAlwaysMsgf(IsValid(Pawn), TEXT("Unable to retrieve the owning Pawn."));
 	return Pawn;
 }
 
-AController* UNinjaInputManagerComponent::GetController() const
+AController* UNinjaInputManagerComponent::ResolveController() const
 {
 	TObjectPtr<AController> Controller = nullptr;
 
@@ -574,7 +821,6 @@ AController* UNinjaInputManagerComponent::GetController() const
 		Controller = PlayerState->GetOwningController();
 	}
 
-	ensureAlwaysMsgf(IsValid(Controller), TEXT("Unable to retrieve the owning Controller."));
 	return Controller;
 }
 
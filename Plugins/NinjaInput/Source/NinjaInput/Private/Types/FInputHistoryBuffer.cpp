@@ -0,0 +1,118 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#include "Types/FInputHistoryBuffer.h"
+
+#include "GameplayTagsManager.h"
+#include "InputAction.h"
+#include "Serialization/MemoryWriter.h"
+
+void FInputHistoryBuffer::Initialize(const int32 Capacity, const int32 MaxActions)
+{
+    Records.SetNumZeroed(FMath::Max(1, Capacity));
+    
+    ActionCapacity = FMath::Clamp(MaxActions, 1, static_cast<int32>(UnknownAction));
+    Actions.Empty(ActionCapacity);
+
+    Head = 0;
+    Count = 0;
+}
+
+void FInputHistoryBuffer::Reset()
+{
+    Head = 0;
+    Count = 0;
+}
+
+void FInputHistoryBuffer::Record(const uint32 ServerFrame, const float ServerTime, const FGameplayTag& EventTag,
+    const float Magnitude, const UInputAction* InputAction)
+{
+    if (!IsInitialized())
+    {
+        return;
+    }
+    
+    FInputHistoryRecord& Entry = Records[Head];
+    Entry.ServerFrame = ServerFrame;
+    Entry.ServerTime = ServerTime;
+    Entry.Magnitude = Magnitude;
+    Entry.EventTag = UGameplayTagsManager::Get().GetNetIndexFromTag(EventTag);
+    Entry.InputAction = GetActionIndex(InputAction);
+
+    Head = (Head + 1) % Records.Num();
+    Count = FMath::Min(Count + 1, Records.Num());
+}
+
+uint16 FInputHistoryBuffer::GetActionIndex(const UInputAction* InputAction)
+{
+    if (InputAction == nullptr)
+    {
+        return UnknownAction;
+    }
+
+    // The table is small and most events come from a handful of actions.
+    for (int32 Index = 0; Index < Actions.Num(); ++Index)
+    {
+        if (Actions[Index] == InputAction)
+        {
+            return static_cast<uint16>(Index);
+        }
+    }
+
+    // Only grows within the reserved capacity, so this never allocates.
+    if (Actions.Num() < ActionCapacity)
+    {
+        return static_cast<uint16>(Actions.Add(InputAction));
+    }
+
+    return UnknownAction;
+}
+
+int32 FInputHistoryBuffer::Serialize(const float MinServerTime, TArray<uint8>& OutData) const
+{
+    OutData.Reset();
+    
+    TArray<const FInputHistoryRecord*> Selected;
+    Selected.Reserve(Count);
+
+    TArray<uint16> TagIndices;
+    const int32 First = (Head - Count + Records.Num()) % FMath::Max(1, Records.Num());
+    
+    for (int32 Offset = 0; Offset < Count; ++Offset)
+    {
+        const FInputHistoryRecord& Entry = Records[(First + Offset) % Records.Num()];
+        if (Entry.ServerTime >= MinServerTime)
+        {
+            Selected.Add(&Entry);
+            TagIndices.AddUnique(Entry.EventTag);
+        }
+    }
+
+    FMemoryWriter Writer(OutData);
+
+    uint32 HeaderMagic = Magic;
+    uint16 HeaderVersion = Version;
+    uint32 RecordCount = Selected.Num();
+    uint32 ActionCount = Actions.Num();
+    uint32 TagCount = TagIndices.Num();
+    Writer << HeaderMagic << HeaderVersion << RecordCount << ActionCount << TagCount;
+
+    for (const TWeakObjectPtr<const UInputAction>& Action : Actions)
+    {
+        FString ActionPath = Action.IsValid() ? Action->GetPathName() : FString();
+        Writer << ActionPath;
+    }
+
+    const UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
+    for (uint16 TagIndex : TagIndices)
+    {
+        FString TagName = TagsManager.GetTagNameFromNetIndex(TagIndex).ToString();
+        Writer << TagIndex << TagName;
+    }
+
+    for (const FInputHistoryRecord* Entry : Selected)
+    {
+        FInputHistoryRecord Copy = *Entry;
+        Writer << Copy.ServerFrame << Copy.ServerTime << Copy.Magnitude << Copy.EventTag << Copy.InputAction;
+    }
+
+    return Selected.Num();
+}
@@ -3,9 +3,118 @@
 
 #include "AbilitySystemComponent.h"
 #include "NinjaInputManagerComponent.h"
+#include "AbilitySystem/NinjaGASAbilitySystemComponent.h"
 
 struct FNinjaInputHandlerHelpers
 {
+    /**
+     * Finds an Ability Spec by class, using the indexed lookup when the ASC is a Ninja GAS component.
+     */
+    static const FGameplayAbilitySpec* FindAbilitySpecByClass(const UAbilitySystemComponent* AbilitySystemComponent, const TSubclassOf<UGameplayAbility>& AbilityClass)
+    {
+        if (const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent))
+        {
+            return NinjaAbilityComponent->FindAbilitySpecByClass(AbilityClass);
+        }
+
+        return AbilitySystemComponent->FindAbilitySpecFromClass(AbilityClass);
+    }
+
+    /**
+     * Finds all Ability Specs matching the tags, using the indexed lookup when the ASC is a Ninja GAS component.
+     */
+    static void FindAbilitySpecsByTags(const UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& AbilityTags, TArray<const FGameplayAbilitySpec*>& OutSpecs)
+    {
+        if (const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent))
+        {
+            NinjaAbilityComponent->FindAbilitySpecsByTags(AbilityTags, OutSpecs);
+            return;
+        }
+
+        TArray<FGameplayAbilitySpecHandle> Handles;
+        AbilitySystemComponent->FindAllAbilitiesWithTags(Handles, AbilityTags);
+        
+        for (const FGameplayAbilitySpecHandle& Handle : Handles)
+        {
+            if (const FGameplayAbilitySpec* Spec = AbilitySystemComponent->FindAbilitySpecFromHandle(Handle))
+            {
+                OutSpecs.Add(Spec);
+            }
+        }
+    }
+
+    /**
+     * Finds all Ability Specs for an Input ID, using the indexed lookup when the ASC is a Ninja GAS component.
+     */
+    static void FindAbilitySpecsByInputID(const UAbilitySystemComponent* AbilitySystemComponent, const int32 InputID, TArray<const FGameplayAbilitySpec*>& OutSpecs)
+    {
+        if (const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent))
+        {
+            NinjaAbilityComponent->FindAbilitySpecsByInputID(InputID, OutSpecs);
+            return;
+        }
+
+        AbilitySystemComponent->FindAllAbilitySpecsFromInputID(InputID, OutSpecs);
+    }
+    
+    /**
+     * Provides the Ninja GAS component, if it can batch RPCs for abilities activated by input.
+     */
+    static UNinjaGASAbilitySystemComponent* GetFrameBatchingComponent(UAbilitySystemComponent* AbilitySystemComponent)
+    {
+        UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent);
+        return IsValid(NinjaAbilityComponent) && NinjaAbilityComponent->CanBatchAbilityRPCsForFrame() ? NinjaAbilityComponent : nullptr;
+    }
+
+    /**
+     * Adds the ability with the given class to the frame-scoped RPC batch, if it opted in and the ASC supports it.
+     */
+    static void BatchAbilityRPCsByClass(UAbilitySystemComponent* AbilitySystemComponent, const TSubclassOf<UGameplayAbility>& AbilityClass)
+    {
+        if (UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = GetFrameBatchingComponent(AbilitySystemComponent))
+        {
+            if (const FGameplayAbilitySpec* Spec = NinjaAbilityComponent->FindAbilitySpecByClass(AbilityClass))
+            {
+                NinjaAbilityComponent->AddToFrameAbilityRPCBatch(Spec->Handle);
+            }
+        }
+    }
+
+    /**
+     * Adds all abilities matching the tags to the frame-scoped RPC batch, if they opted in and the ASC supports it.
+     */
+    static void BatchAbilityRPCsByTags(UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& AbilityTags)
+    {
+        if (UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = GetFrameBatchingComponent(AbilitySystemComponent))
+        {
+            // Same matching rules as "TryActivateAbilitiesByTag", which accepts parent tags.
+            TArray<const FGameplayAbilitySpec*> Specs;
+            NinjaAbilityComponent->FindAbilitySpecsByTags(AbilityTags, Specs, false);
+            
+            for (const FGameplayAbilitySpec* Spec : Specs)
+            {
+                NinjaAbilityComponent->AddToFrameAbilityRPCBatch(Spec->Handle);
+            }
+        }
+    }
+
+    /**
+     * Adds all abilities bound to the Input ID to the frame-scoped RPC batch, if they opted in and the ASC supports it.
+     */
+    static void BatchAbilityRPCsByInputID(UAbilitySystemComponent* AbilitySystemComponent, const int32 InputID)
+    {
+        if (UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = GetFrameBatchingComponent(AbilitySystemComponent))
+        {
+            TArray<const FGameplayAbilitySpec*> Specs;
+            NinjaAbilityComponent->FindAbilitySpecsByInputID(InputID, Specs);
+            
+            for (const FGameplayAbilitySpec* Spec : Specs)
+            {
+                NinjaAbilityComponent->AddToFrameAbilityRPCBatch(Spec->Handle);
+            }
+        }
+    }
+    
     /**
      * Checks if the owner's ASC passes the provided query test.
      * In this context, an empty query will be ignored and the test will return true.
@@ -26,6 +135,53 @@ struct FNinjaInputHandlerHelpers
         return OutContainer.MatchesQuery(Query);
     }
     
+    /**
+     * Checks if an ability of the given class is active.
+     * Uses the active ability counts when the ASC is a Ninja GAS component.
+     */
+    static bool IsAbilityClassActive(const UAbilitySystemComponent* AbilitySystemComponent, const TSubclassOf<UGameplayAbility>& AbilityClass)
+    {
+        if (const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent))
+        {
+            return NinjaAbilityComponent->IsAbilityClassActive(AbilityClass);
+        }
+
+        const FGameplayAbilitySpec* Spec = AbilitySystemComponent->FindAbilitySpecFromClass(AbilityClass);
+        return Spec != nullptr && Spec->Handle.IsValid() && Spec->IsActive();
+    }
+
+    /**
+     * Checks if an ability matching the tags is active.
+     * Uses the active ability counts when the ASC is a Ninja GAS component.
+     */
+    static bool HasActiveAbilityWithTags(const UAbilitySystemComponent* AbilitySystemComponent, const FGameplayTagContainer& AbilityTags)
+    {
+        if (const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent))
+        {
+            return NinjaAbilityComponent->HasActiveAbilityWithTags(AbilityTags);
+        }
+
+        TArray<const FGameplayAbilitySpec*> Specs;
+        FindAbilitySpecsByTags(AbilitySystemComponent, AbilityTags, Specs);
+        return Specs.ContainsByPredicate([](const FGameplayAbilitySpec* Spec) { return Spec->Handle.IsValid() && Spec->IsActive(); });
+    }
+
+    /**
+     * Checks if an ability bound to the Input ID is active.
+     * Uses the active ability counts when the ASC is a Ninja GAS component.
+     */
+    static bool HasActiveAbilityWithInputID(const UAbilitySystemComponent* AbilitySystemComponent, const int32 InputID)
+    {
+        if (const UNinjaGASAbilitySystemComponent* NinjaAbilityComponent = Cast<UNinjaGASAbilitySystemComponent>(AbilitySystemComponent))
+        {
+            return NinjaAbilityComponent->HasActiveAbilityWithInputID(InputID);
+        }
+
+        TArray<const FGameplayAbilitySpec*> Specs;
+        FindAbilitySpecsByInputID(AbilitySystemComponent, InputID, Specs);
+        return Specs.ContainsByPredicate([](const FGameplayAbilitySpec* Spec) { return Spec->Handle.IsValid() && Spec->IsActive(); });
+    }
+    
     /**
      * Sends a Gameplay Event, through the manager's ASC.
      *
@@ -69,7 +225,7 @@ struct FNinjaInputHandlerHelpers
         const TObjectPtr<UAbilitySystemComponent> AbilitySystemComponent = Manager->GetAbilitySystemComponent();
         if (ensure(IsValid(AbilitySystemComponent)))
         {
-            const FGameplayAbilitySpec* Spec = AbilitySystemComponent->FindAbilitySpecFromClass(AbilityClass);
+            const FGameplayAbilitySpec* Spec = FindAbilitySpecByClass(AbilitySystemComponent, AbilityClass);
             if (Spec != nullptr && Spec->Handle.IsValid())
             {
                 UE_LOG(LogNinjaInputHandler, Verbose, TEXT("[%s] Action %s is interrupting ability with class %s."),
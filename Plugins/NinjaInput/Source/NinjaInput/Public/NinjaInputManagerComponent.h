@@ -5,11 +5,14 @@
 #include "AbilitySystemInterface.h"
 #include "GameplayTagContainer.h"
 #include "NinjaInputBufferComponent.h"
+#include "Types/FInputHistoryBuffer.h"
 #include "Types/FProcessedBinding.h"
 #include "Types/FProcessedInputSetup.h"
 #include "NinjaInputManagerComponent.generated.h"
 
 class APawn;
+class APlayerController;
+class APlayerState;
 class UEnhancedInputComponent;
 class UArrowComponent;
 class UEnhancedInputLocalPlayerSubsystem;
@@ -50,6 +53,7 @@ public:
 
 	virtual void OnRegister() override;
     virtual void OnUnregister() override;
+    virtual void BeginPlay() override;
 
 	/** 注册当前所有者所装载的技能组件 */
 	//UFUNCTION(BlueprintCallable, Category = "TD|Input Component")
@@ -86,6 +90,9 @@ public:
 	 * This function is able to retrieve the pawn even if this component is attached to actors
 	 * that are not pawns, such as Controllers or Player States.
 	 *
+	 * The pawn is cached when this component registers and refreshed whenever the pawn restarts
+	 * or its possession changes, so this is cheap enough to be called on every input event.
+	 *
 	 * @return
 	 *		The Pawn that owns this component. It may be the owning actor or the pawn related
 	 *		to a Controller or to a Player State. It will ultimately ensure that is not null.
@@ -99,6 +106,8 @@ public:
 	 * This function is able to retrieve the controller, regardless of the actor that owns
 	 * it, which may be a Pawn, an Controller or a Player State.
 	 *
+	 * The controller is cached and refreshed whenever the pawn's controller changes.
+	 *
 	 * @return
 	 *		The Controller that owns this component. It may be retrieved from the owning Pawn,
 	 *		Player State or the owning controller itself. It will ensure that is not null.
@@ -106,6 +115,19 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Ninja Input|Input Manager Component")
 	AController* GetController() const;
 
+	/**
+	 * Provides the player controller that owns this component.
+	 *
+	 * Same as "GetController", but only returns controllers that belong to players. Does not
+	 * ensure, since pawns may be legitimately controlled by other types of controllers.
+	 *
+	 * @return
+	 *		The Player Controller that owns this component, or null if the owner is not
+	 *		controlled by a player.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Ninja Input|Input Manager Component")
+	APlayerController* GetPlayerController() const;
+
     /**
      * Checks if this component is running with a local controller.
      *
@@ -114,6 +136,18 @@ public:
      */
     UFUNCTION(BlueprintPure, Category = "Ninja Input|Manager Component")
     bool IsLocallyControlled() const;
+
+    /**
+     * Checks if this component is actively handling input.
+     *
+     * Managers only become active for locally controlled pawns. On simulated proxies and pawns
+     * controlled remotely or by AI, they stay dormant, without bindings or buffered commands.
+     *
+     * @return
+     *      A boolean informing if this Manager Component has its input setup active.
+     */
+    UFUNCTION(BlueprintPure, Category = "Ninja Input|Manager Component")
+    bool IsInputActive() const { return bInputActive; }
     
 	/**
 	 * Provides the Ability System Component from this component's owner.
@@ -227,6 +261,27 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Ninja Input|Input Manager Component")
     int32 SendGameplayEventToOwner(const FGameplayTag& GameplayEventTag, const FInputActionValue& Value,
         const UInputAction* InputAction, bool bSendLocally = true, bool bSendToServer = true) const;
+
+    /**
+     * Writes the server-side Input History to a binary file.
+     *
+     * Only available on the server, when the Input History is enabled. Files are written to
+     * the "Saved/InputHistory" folder and follow the format described in FInputHistoryBuffer.
+     * The history is serialized right away, but the file is written in a background task.
+     *
+     * @param Reason
+     *      Short description of why the history is being dumped. Added to the file name.
+     *
+     * @return
+     *      The path to the file being written, or an empty string if there is nothing to write.
+     */
+    UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Ninja Input|Input Manager Component")
+    FString DumpInputHistory(const FString& Reason) const;
+
+    /**
+     * Provides the server-side Input History, for in-process analysis.
+     */
+    const FInputHistoryBuffer& GetInputHistory() const { return InputHistory; }
     
 protected:
 
@@ -244,10 +299,53 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input")
     TArray<TObjectPtr<UNinjaInputSetupDataAsset>> InputHandlerSetup;
 
+    /**
+     * Records gameplay events received from the owning client, on the server.
+     *
+     * Useful for replays and for reviewing suspicious play. Memory is allocated once, when
+     * play begins, and is bounded by the duration and the expected event rate.
+     */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input History")
+    bool bRecordInputHistory;
+
+    /** How many seconds of gameplay events should be kept in the Input History. */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input History", meta = (EditCondition = "bRecordInputHistory", ClampMin = 1.f, UIMin = 1.f, Units = "s"))
+    float InputHistoryDuration;
+
+    /** Maximum expected rate of gameplay events. Together with the duration, sets the history capacity. */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input History", meta = (EditCondition = "bRecordInputHistory", ClampMin = 1, UIMin = 1))
+    int32 InputHistoryEventsPerSecond;
+
+    /** Gameplay events with any of these tags will dump the Input History once received. */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input History", meta = (EditCondition = "bRecordInputHistory"))
+    FGameplayTagContainer InputHistoryDumpTags;
+
+    /** Minimum time between dumps triggered by gameplay events, since these are requested by the client. */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input History", meta = (EditCondition = "bRecordInputHistory", ClampMin = 0.f, UIMin = 0.f, Units = "s"))
+    float InputHistoryDumpInterval;
+
     /**
      * Entrypoint for the component's initialization. 
      */
     void SetupInputComponent(const APawn* Pawn);
+
+    /**
+     * Releases all bindings and buffered commands, until the pawn becomes locally controlled.
+     */
+    virtual void EnterDormancy();
+
+    /**
+     * Updates the replication state, based on the pawn's controller. Only relevant for authority.
+     *
+     * Replication is only required for player-controlled pawns, so the owning client can send
+     * gameplay events to the server. Pawns controlled by AI, or not controlled at all, do not
+     * need a replicated manager.
+     */
+    void UpdateReplicationState(const APawn* Pawn);
+
+    // -- Begin Input Buffer Interface
+    virtual void OpenInputBuffer_Implementation() override;
+    // -- End Input Buffer Interface
     
     /**
      * Registers a new Input Mapping Context and process necessary bindings.
@@ -360,6 +458,23 @@ protected:
 	UFUNCTION()
 	void OnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);	
 
+	/**
+	 * Invoked when an owning Controller possesses a new pawn, refreshing the cached pawn.
+	 */
+	UFUNCTION()
+	void OnPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn);
+
+	/**
+	 * Invoked when an owning Player State is assigned to a new pawn, refreshing the cached pawn.
+	 */
+	UFUNCTION()
+	void OnPlayerStatePawnSet(APlayerState* PlayerState, APawn* NewPawn, APawn* OldPawn);
+
+	/**
+	 * Resolves the owning pawn and controllers and stores them for quick access.
+	 */
+	void RefreshOwnerCache();
+
     /**
      * Provides a vector reference for a given axis.
      *
@@ -370,10 +485,18 @@ protected:
 
 private:
 
+	/** Pawn currently related to our owner. */
+	UPROPERTY()
+	TObjectPtr<APawn> OwnerPawn;
+	
 	/** Controller currently assigned to our owner. */
 	UPROPERTY()
 	TObjectPtr<AController> OwnerController;
 
+	/** Same as the Owner Controller, when it belongs to a player. */
+	UPROPERTY()
+	TObjectPtr<APlayerController> OwnerPlayerController;
+
 	/** 当前所有者的技能组件 */
 	UPROPERTY()
 	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
@@ -382,9 +505,21 @@ private:
 	UPROPERTY()
 	TObjectPtr<UArrowComponent> ForwardReference;
 
+	/** Informs if this component is handling input, which only happens for locally controlled pawns. */
+	bool bInputActive;
+
     /** All setups registered to this component, mapped by their Mapping Context.*/
     UPROPERTY()
     TMap<TObjectPtr<UInputMappingContext>, FProcessedInputSetup> ProcessedSetups;
+
+    /** Gameplay events received from the owning client. Only allocated on the server. */
+    mutable FInputHistoryBuffer InputHistory;
+
+    /** Server time of the last dump triggered by a gameplay event. */
+    mutable double LastInputHistoryDumpTime;
+
+    /** Dumps written by this component, used to keep file names unique. */
+    mutable int32 InputHistoryDumpCount;
     
     /**
      * Allows sending a gameplay event to server when we are a local autonomous proxy.
@@ -400,5 +535,11 @@ private:
     UFUNCTION(Client, Reliable)
     void Client_SendGameplayEventToOwner(const FGameplayTag& GameplayEventTag,
         const FInputActionValue& Value, const UInputAction* InputAction) const;
+
+    /** Resolves the pawn from the owner, without using the cache. */
+    APawn* ResolvePawn() const;
+
+    /** Resolves the controller from the owner, without using the cache. */
+    AController* ResolveController() const;
     
 };
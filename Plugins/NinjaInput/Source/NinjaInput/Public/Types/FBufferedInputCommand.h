@@ -9,6 +9,7 @@
 class UNinjaInputManagerComponent;
 class UInputAction;
 class UNinjaInputHandler;
+class UNinjaInputSetupDataAsset;
 
 /**
  * Represents a buffered command that may be executed later.
@@ -39,6 +40,10 @@ struct FBufferedInputCommand
     UPROPERTY(BlueprintReadOnly, Category = "Input Command")
     ETriggerEvent TriggerEvent;
 
+    /** Setup that provided the Handler. Allows removing all commands from a setup at once. */
+    UPROPERTY(BlueprintReadOnly, Category = "Input Command")
+    TObjectPtr<const UNinjaInputSetupDataAsset> SourceSetup;
+
     FBufferedInputCommand()
     {
     	Source = nullptr;
@@ -46,18 +51,21 @@ struct FBufferedInputCommand
         Handler = nullptr;
         Value.Reset();
         TriggerEvent = ETriggerEvent::None;
+        SourceSetup = nullptr;
     }
 
     explicit FBufferedInputCommand(UNinjaInputManagerComponent* Source
         , const UInputAction* Action
         , const UNinjaInputHandler* Handler
         , const FInputActionValue& Value
-        , const ETriggerEvent TriggerEvent)
+        , const ETriggerEvent TriggerEvent
+        , const UNinjaInputSetupDataAsset* SourceSetup = nullptr)
         : Source(Source)
         , InputAction(Action)
         , Handler(Handler)
         , Value(Value)
         , TriggerEvent(TriggerEvent)
+        , SourceSetup(SourceSetup)
     {
     }
 
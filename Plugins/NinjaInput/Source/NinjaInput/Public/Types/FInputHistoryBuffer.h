@@ -0,0 +1,115 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+class UInputAction;
+
+/**
+ * Compact record of a gameplay event received by the server.
+ *
+ * Tags are stored using their network index and actions as an index into the buffer's
+ * action table, so every record has the same, fixed size.
+ */
+struct FInputHistoryRecord
+{
+    /** Server frame in which the event was received. */
+    uint32 ServerFrame = 0;
+
+    /** Server world time in which the event was received. */
+    float ServerTime = 0.f;
+
+    /** Magnitude of the input value that triggered the event. */
+    float Magnitude = 0.f;
+
+    /** Network index of the Gameplay Event Tag. */
+    uint16 EventTag = 0;
+
+    /** Index of the Input Action in the buffer's action table. */
+    uint16 InputAction = 0;
+};
+
+static_assert(sizeof(FInputHistoryRecord) == 16, "Input History Records are expected to be 16 bytes.");
+
+/**
+ * Fixed-capacity ring buffer of gameplay events received by the server.
+ *
+ * All memory is allocated when the buffer is initialized. Recording an event never allocates,
+ * overwriting the oldest record once the buffer is full.
+ */
+class NINJAINPUT_API FInputHistoryBuffer
+{
+    
+public:
+
+    /** Identifies the binary format produced by this buffer. */
+    static constexpr uint32 Magic = 0x3148494E; // "NIH1"
+    static constexpr uint16 Version = 1;
+
+    /** Action index used when the action table is full or no action was provided. */
+    static constexpr uint16 UnknownAction = MAX_uint16;
+
+    /**
+     * Allocates the buffer storage, discarding any previous records.
+     *
+     * @param Capacity
+     *      Maximum number of records kept by the buffer.
+     *
+     * @param MaxActions
+     *      Maximum number of distinct Input Actions tracked by the action table.
+     */
+    void Initialize(int32 Capacity, int32 MaxActions = 64);
+
+    /** Checks if the buffer has storage allocated. */
+    bool IsInitialized() const { return !Records.IsEmpty(); }
+
+    /** Provides the number of records currently stored. */
+    int32 Num() const { return Count; }
+
+    /** Removes all records, keeping the allocated storage. */
+    void Reset();
+
+    /**
+     * Records a new event, overwriting the oldest one if the buffer is full.
+     */
+    void Record(uint32 ServerFrame, float ServerTime, const FGameplayTag& EventTag, float Magnitude, const UInputAction* InputAction);
+
+    /**
+     * Writes all records received at or after a given time, from oldest to newest.
+     *
+     * The output starts with a header (magic, version, counts), followed by the action table
+     * (object paths), the tag table (network index and name) and finally the records.
+     *
+     * @param MinServerTime
+     *      Oldest server time to be included in the output.
+     *
+     * @param OutData
+     *      Binary representation of the selected records.
+     *
+     * @return
+     *      The number of records written.
+     */
+    int32 Serialize(float MinServerTime, TArray<uint8>& OutData) const;
+
+private:
+
+    /** Storage for all records. Allocated once, on initialization. */
+    TArray<FInputHistoryRecord> Records;
+
+    /** Actions referenced by the records. Reserved once, on initialization. */
+    TArray<TWeakObjectPtr<const UInputAction>> Actions;
+
+    /** Maximum number of entries in the action table. */
+    int32 ActionCapacity = 0;
+
+    /** Index where the next record will be written. */
+    int32 Head = 0;
+
+    /** Number of valid records. */
+    int32 Count = 0;
+
+    /** Finds or registers an action in the action table. */
+    uint16 GetActionIndex(const UInputAction* InputAction);
+    
+};
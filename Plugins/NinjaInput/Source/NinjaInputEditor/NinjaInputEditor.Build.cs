@@ -25,7 +25,9 @@ public class NinjaInputEditor : ModuleRules
 		        "GraphEditor",
 		        "InputBlueprintNodes",
 		        "InputCore",
+		        "Json",
 		        "KismetCompiler",
+		        "Projects",
 		        "PropertyEditor",
 		        "SharedSettingsWidgets",
 		        "Slate",
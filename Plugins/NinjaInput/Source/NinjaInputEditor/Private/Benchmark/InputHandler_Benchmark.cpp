@@ -0,0 +1,30 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#include "Benchmark/InputHandler_Benchmark.h"
+
+UInputHandler_Benchmark::UInputHandler_Benchmark()
+{
+    HandledCount = 0;
+    TriggerEvents.Add(ETriggerEvent::Triggered);
+}
+
+void UInputHandler_Benchmark::Configure(const TArray<UInputAction*>& Actions, const bool bBuffered)
+{
+    InputActions.Reset(Actions.Num());
+    for (UInputAction* Action : Actions)
+    {
+        InputActions.Add(Action);
+    }
+    
+    bCanBeBuffered = bBuffered;
+}
+
+void UInputHandler_Benchmark::SetCanBeBuffered(const bool bBuffered)
+{
+    bCanBeBuffered = bBuffered;
+}
+
+void UInputHandler_Benchmark::HandleTriggeredEvent_Implementation(UNinjaInputManagerComponent* Manager,
+    const FInputActionValue& Value, const UInputAction* InputAction) const
+{
+    ++HandledCount;
+}
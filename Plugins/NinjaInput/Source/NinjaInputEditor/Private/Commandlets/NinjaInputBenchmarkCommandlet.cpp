@@ -0,0 +1,421 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#include "Commandlets/NinjaInputBenchmarkCommandlet.h"
+
+#include "EnhancedInputComponent.h"
+#include "InputAction.h"
+#include "InputMappingContext.h"
+#include "NinjaInputEditor.h"
+#include "Benchmark/InputHandler_Benchmark.h"
+#include "Benchmark/NinjaInputBenchmarkManagerComponent.h"
+#include "Data/NinjaInputSetupDataAsset.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace NinjaInputBenchmark
+{
+    /**
+     * Reads the allocator's own call counters, which are only maintained in builds with stats.
+     *
+     * The allocator is never replaced, so the counters include other threads. The benchmark
+     * runs headless, so the delta around the dispatch loop is dominated by the game thread.
+     */
+    static bool GetAllocationCalls(uint64& OutCalls)
+    {
+#if STATS
+        OutCalls = static_cast<uint64>(FMalloc::TotalMallocCalls) + static_cast<uint64>(FMalloc::TotalReallocCalls);
+        return true;
+#else
+        OutCalls = 0;
+        return false;
+#endif
+    }
+    
+    static double ToMicroseconds(const uint64 Cycles)
+    {
+        return FPlatformTime::ToMilliseconds64(Cycles) * 1000.0;
+    }
+}
+
+UNinjaInputBenchmarkCommandlet::UNinjaInputBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+
+    HelpDescription = TEXT("Benchmarks the Ninja Input Manager dispatch, buffer and setup paths.");
+    HelpUsage = TEXT("-run=NinjaInputBenchmark [-Setups=4] [-Handlers=16] [-Actions=8] [-Events=100000] [-Iterations=100] [-Output=<Path>.json]");
+}
+
+int32 UNinjaInputBenchmarkCommandlet::Main(const FString& Params)
+{
+    const FBenchmarkSettings Settings = ParseSettings(Params);
+    UE_LOG(LogNinjaInputEditor, Display, TEXT("Running Ninja Input benchmark: %d setups, %d handlers and %d actions per setup, %d events, %d iterations."),
+        Settings.Setups, Settings.HandlersPerSetup, Settings.ActionsPerSetup, Settings.Events, Settings.Iterations);
+
+    UWorld* World = CreateBenchmarkWorld();
+    if (!IsValid(World))
+    {
+        UE_LOG(LogNinjaInputEditor, Error, TEXT("Unable to create the benchmark world."));
+        return 1;
+    }
+    
+    UNinjaInputBenchmarkManagerComponent* Manager = SpawnBenchmarkPawn(World);
+    if (!IsValid(Manager))
+    {
+        UE_LOG(LogNinjaInputEditor, Error, TEXT("Unable to create the benchmark pawn and its Input Manager."));
+        DestroyBenchmarkWorld(World);
+        return 1;
+    }
+    
+    CreateSetups(Settings);
+
+    const TSharedRef<FJsonObject> Configuration = MakeShared<FJsonObject>();
+    Configuration->SetNumberField(TEXT("setups"), Settings.Setups);
+    Configuration->SetNumberField(TEXT("handlersPerSetup"), Settings.HandlersPerSetup);
+    Configuration->SetNumberField(TEXT("actionsPerSetup"), Settings.ActionsPerSetup);
+    Configuration->SetNumberField(TEXT("events"), Settings.Events);
+    Configuration->SetNumberField(TEXT("iterations"), Settings.Iterations);
+
+    const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("NinjaInput"));
+    
+    const TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("engineVersion"), FEngineVersion::Current().ToString());
+    Report->SetStringField(TEXT("pluginVersion"), Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : TEXT("Unknown"));
+    Report->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+    Report->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+    Report->SetObjectField(TEXT("configuration"), Configuration);
+    Report->SetObjectField(TEXT("setupChanges"), MeasureSetupChanges(Manager, Settings));
+    Report->SetObjectField(TEXT("dispatch"), MeasureDispatch(Manager, Settings));
+    Report->SetObjectField(TEXT("buffer"), MeasureBuffer(Manager, Settings));
+
+    DestroyBenchmarkWorld(World);
+
+    FString Output;
+    const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+    FJsonSerializer::Serialize(Report, Writer);
+
+    if (!FFileHelper::SaveStringToFile(Output, *Settings.OutputPath))
+    {
+        UE_LOG(LogNinjaInputEditor, Error, TEXT("Unable to write benchmark results to %s."), *Settings.OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogNinjaInputEditor, Display, TEXT("Benchmark results written to %s."), *Settings.OutputPath);
+    UE_LOG(LogNinjaInputEditor, Display, TEXT("%s"), *Output);
+    return 0;
+}
+
+UNinjaInputBenchmarkCommandlet::FBenchmarkSettings UNinjaInputBenchmarkCommandlet::ParseSettings(const FString& Params)
+{
+    FBenchmarkSettings Settings;
+    FParse::Value(*Params, TEXT("Setups="), Settings.Setups);
+    FParse::Value(*Params, TEXT("Handlers="), Settings.HandlersPerSetup);
+    FParse::Value(*Params, TEXT("Actions="), Settings.ActionsPerSetup);
+    FParse::Value(*Params, TEXT("Events="), Settings.Events);
+    FParse::Value(*Params, TEXT("Iterations="), Settings.Iterations);
+
+    Settings.Setups = FMath::Max(1, Settings.Setups);
+    Settings.HandlersPerSetup = FMath::Max(1, Settings.HandlersPerSetup);
+    Settings.ActionsPerSetup = FMath::Max(1, Settings.ActionsPerSetup);
+    Settings.Events = FMath::Max(1, Settings.Events);
+    Settings.Iterations = FMath::Max(1, Settings.Iterations);
+
+    if (!FParse::Value(*Params, TEXT("Output="), Settings.OutputPath))
+    {
+        const FString FileName = FString::Printf(TEXT("NinjaInput-%s.json"), *FDateTime::Now().ToString());
+        Settings.OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"), FileName);
+    }
+    
+    return Settings;
+}
+
+UWorld* UNinjaInputBenchmarkCommandlet::CreateBenchmarkWorld()
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("NinjaInputBenchmark"));
+    if (IsValid(World))
+    {
+        FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+        WorldContext.SetCurrentWorld(World);
+
+        World->InitializeActorsForPlay(FURL());
+        World->BeginPlay();
+    }
+
+    return World;
+}
+
+void UNinjaInputBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+    if (IsValid(World))
+    {
+        World->BeginTearingDown();
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+    }
+}
+
+UNinjaInputBenchmarkManagerComponent* UNinjaInputBenchmarkCommandlet::SpawnBenchmarkPawn(UWorld* World)
+{
+    APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+    APawn* Pawn = World->SpawnActor<APawn>();
+    if (!IsValid(PlayerController) || !IsValid(Pawn))
+    {
+        return nullptr;
+    }
+
+    // The local player provides the Enhanced Input Subsystem used to register the contexts.
+    ULocalPlayer* LocalPlayer = NewObject<ULocalPlayer>(GEngine, ULocalPlayer::StaticClass());
+    LocalPlayer->PlayerAdded(nullptr, FPlatformMisc::GetPlatformUserForUserIndex(0));
+    PlayerController->SetPlayer(LocalPlayer);
+
+    // Provide the Enhanced Input Component before possession, so the pawn won't create a default one.
+    UEnhancedInputComponent* InputComponent = NewObject<UEnhancedInputComponent>(Pawn, TEXT("BenchmarkInputComponent"));
+    InputComponent->RegisterComponent();
+    Pawn->InputComponent = InputComponent;
+    PlayerController->Possess(Pawn);
+
+    // Registering the manager on a restarted pawn initializes it right away.
+    UNinjaInputBenchmarkManagerComponent* Manager = NewObject<UNinjaInputBenchmarkManagerComponent>(Pawn, TEXT("BenchmarkInputManager"));
+    Manager->RegisterComponent();
+    return Manager;
+}
+
+void UNinjaInputBenchmarkCommandlet::CreateSetups(const FBenchmarkSettings& Settings)
+{
+    static const FKey Keys[] = { EKeys::A, EKeys::B, EKeys::C, EKeys::D, EKeys::E, EKeys::F, EKeys::G, EKeys::H };
+    
+    Setups.Reset(Settings.Setups);
+    Actions.Reset(Settings.Setups * Settings.ActionsPerSetup);
+    Handlers.Reset(Settings.Setups * Settings.HandlersPerSetup);
+
+    for (int32 SetupIndex = 0; SetupIndex < Settings.Setups; ++SetupIndex)
+    {
+        UInputMappingContext* Context = NewObject<UInputMappingContext>(GetTransientPackage());
+        BenchmarkObjects.Add(Context);
+
+        TArray<UInputAction*> SetupActions;
+        SetupActions.Reserve(Settings.ActionsPerSetup);
+        
+        for (int32 ActionIndex = 0; ActionIndex < Settings.ActionsPerSetup; ++ActionIndex)
+        {
+            UInputAction* Action = NewObject<UInputAction>(GetTransientPackage());
+            Action->ValueType = EInputActionValueType::Boolean;
+            Context->MapKey(Action, Keys[ActionIndex % UE_ARRAY_COUNT(Keys)]);
+            
+            SetupActions.Add(Action);
+            Actions.Add(Action);
+        }
+
+        UNinjaInputSetupDataAsset* Setup = NewObject<UNinjaInputSetupDataAsset>(GetTransientPackage());
+        Setup->Priority = SetupIndex;
+        Setup->InputMappingContext = Context;
+
+        // Each handler responds to a single action, distributing handlers evenly across actions.
+        for (int32 HandlerIndex = 0; HandlerIndex < Settings.HandlersPerSetup; ++HandlerIndex)
+        {
+            UInputHandler_Benchmark* Handler = NewObject<UInputHandler_Benchmark>(Setup);
+            Handler->Configure({ SetupActions[HandlerIndex % SetupActions.Num()] }, false);
+            
+            Setup->InputHandlers.Add(Handler);
+            Handlers.Add(Handler);
+        }
+
+        Setups.Add(Setup);
+    }
+}
+
+TSharedRef<FJsonObject> UNinjaInputBenchmarkCommandlet::MeasureSetupChanges(UNinjaInputBenchmarkManagerComponent* Manager,
+    const FBenchmarkSettings& Settings) const
+{
+    uint64 AddCycles = 0;
+    uint64 RemoveCycles = 0;
+
+    for (int32 Iteration = 0; Iteration < Settings.Iterations; ++Iteration)
+    {
+        uint64 StartCycles = FPlatformTime::Cycles64();
+        for (const UNinjaInputSetupDataAsset* Setup : Setups)
+        {
+            Manager->AddInputSetupData(Setup);
+        }
+        AddCycles += FPlatformTime::Cycles64() - StartCycles;
+
+        StartCycles = FPlatformTime::Cycles64();
+        for (const UNinjaInputSetupDataAsset* Setup : Setups)
+        {
+            Manager->RemoveInputSetupData(Setup);
+        }
+        RemoveCycles += FPlatformTime::Cycles64() - StartCycles;
+    }
+
+    const double Operations = static_cast<double>(Settings.Iterations) * Setups.Num();
+    
+    const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("addMicrosecondsPerSetup"), NinjaInputBenchmark::ToMicroseconds(AddCycles) / Operations);
+    Result->SetNumberField(TEXT("removeMicrosecondsPerSetup"), NinjaInputBenchmark::ToMicroseconds(RemoveCycles) / Operations);
+    return Result;
+}
+
+TSharedRef<FJsonObject> UNinjaInputBenchmarkCommandlet::MeasureDispatch(UNinjaInputBenchmarkManagerComponent* Manager,
+    const FBenchmarkSettings& Settings) const
+{
+    for (const UNinjaInputSetupDataAsset* Setup : Setups)
+    {
+        Manager->AddInputSetupData(Setup);
+    }
+
+    TArray<FInputActionInstance> Instances;
+    Instances.Reserve(Actions.Num());
+    for (const UInputAction* Action : Actions)
+    {
+        Instances.Emplace(Action);
+    }
+
+    // Warm up, so lazily initialized state is not measured.
+    for (const FInputActionInstance& Instance : Instances)
+    {
+        Manager->BenchmarkDispatch(Instance, ETriggerEvent::Triggered);
+    }
+    CollectHandledCount(true);
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    for (int32 EventIndex = 0; EventIndex < Settings.Events; ++EventIndex)
+    {
+        Manager->BenchmarkDispatch(Instances[EventIndex % Instances.Num()], ETriggerEvent::Triggered);
+    }
+    const uint64 ElapsedCycles = FPlatformTime::Cycles64() - StartCycles;
+    const int32 HandledCount = CollectHandledCount(true);
+
+    // Run the same amount of events again, this time only counting allocations.
+    uint64 AllocationCallsBefore = 0;
+    const bool bCountAllocations = NinjaInputBenchmark::GetAllocationCalls(AllocationCallsBefore);
+    if (bCountAllocations)
+    {
+        for (int32 EventIndex = 0; EventIndex < Settings.Events; ++EventIndex)
+        {
+            Manager->BenchmarkDispatch(Instances[EventIndex % Instances.Num()], ETriggerEvent::Triggered);
+        }
+        CollectHandledCount(true);
+    }
+    else
+    {
+        UE_LOG(LogNinjaInputEditor, Warning, TEXT("Allocation counters are only available in builds with stats, allocations per event won't be reported."));
+    }
+
+    uint64 AllocationCallsAfter = 0;
+    NinjaInputBenchmark::GetAllocationCalls(AllocationCallsAfter);
+    const uint64 Allocations = AllocationCallsAfter - AllocationCallsBefore;
+
+    for (const UNinjaInputSetupDataAsset* Setup : Setups)
+    {
+        Manager->RemoveInputSetupData(Setup);
+    }
+
+    const double ElapsedMicroseconds = NinjaInputBenchmark::ToMicroseconds(ElapsedCycles);
+    
+    const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("events"), Settings.Events);
+    Result->SetNumberField(TEXT("handlerInvocations"), HandledCount);
+    Result->SetNumberField(TEXT("totalMilliseconds"), ElapsedMicroseconds / 1000.0);
+    Result->SetNumberField(TEXT("nanosecondsPerEvent"), ElapsedMicroseconds * 1000.0 / Settings.Events);
+    Result->SetNumberField(TEXT("eventsPerSecond"), ElapsedMicroseconds > 0.0 ? Settings.Events / (ElapsedMicroseconds / 1000000.0) : 0.0);
+    if (bCountAllocations)
+    {
+        Result->SetNumberField(TEXT("allocationsPerEvent"), static_cast<double>(Allocations) / Settings.Events);
+    }
+    return Result;
+}
+
+TSharedRef<FJsonObject> UNinjaInputBenchmarkCommandlet::MeasureBuffer(UNinjaInputBenchmarkManagerComponent* Manager,
+    const FBenchmarkSettings& Settings) const
+{
+    for (UInputHandler_Benchmark* Handler : Handlers)
+    {
+        Handler->SetCanBeBuffered(true);
+    }
+    
+    for (const UNinjaInputSetupDataAsset* Setup : Setups)
+    {
+        Manager->AddInputSetupData(Setup);
+    }
+
+    TArray<FInputActionInstance> Instances;
+    Instances.Reserve(Actions.Num());
+    for (const UInputAction* Action : Actions)
+    {
+        Instances.Emplace(Action);
+    }
+
+    uint64 OpenCycles = 0;
+    uint64 BufferedDispatchCycles = 0;
+    uint64 CloseCycles = 0;
+    int32 PeakBufferedCommands = 0;
+
+    for (int32 Iteration = 0; Iteration < Settings.Iterations; ++Iteration)
+    {
+        uint64 StartCycles = FPlatformTime::Cycles64();
+        IInputBufferInterface::Execute_OpenInputBuffer(Manager);
+        OpenCycles += FPlatformTime::Cycles64() - StartCycles;
+
+        StartCycles = FPlatformTime::Cycles64();
+        for (const FInputActionInstance& Instance : Instances)
+        {
+            Manager->BenchmarkDispatch(Instance, ETriggerEvent::Triggered);
+        }
+        BufferedDispatchCycles += FPlatformTime::Cycles64() - StartCycles;
+        PeakBufferedCommands = FMath::Max(PeakBufferedCommands, Manager->GetBufferedCommandCount());
+
+        StartCycles = FPlatformTime::Cycles64();
+        IInputBufferInterface::Execute_CloseInputBuffer(Manager, false);
+        CloseCycles += FPlatformTime::Cycles64() - StartCycles;
+    }
+
+    const int32 HandledCount = CollectHandledCount(true);
+
+    for (const UNinjaInputSetupDataAsset* Setup : Setups)
+    {
+        Manager->RemoveInputSetupData(Setup);
+    }
+    
+    for (UInputHandler_Benchmark* Handler : Handlers)
+    {
+        Handler->SetCanBeBuffered(false);
+    }
+
+    const double Cycles = Settings.Iterations;
+    
+    const TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField(TEXT("cycles"), Settings.Iterations);
+    Result->SetNumberField(TEXT("openMicroseconds"), NinjaInputBenchmark::ToMicroseconds(OpenCycles) / Cycles);
+    Result->SetNumberField(TEXT("bufferedDispatchMicroseconds"), NinjaInputBenchmark::ToMicroseconds(BufferedDispatchCycles) / Cycles);
+    Result->SetNumberField(TEXT("closeMicroseconds"), NinjaInputBenchmark::ToMicroseconds(CloseCycles) / Cycles);
+    Result->SetNumberField(TEXT("peakBufferedCommands"), PeakBufferedCommands);
+    Result->SetNumberField(TEXT("releasedInvocations"), HandledCount);
+    return Result;
+}
+
+int32 UNinjaInputBenchmarkCommandlet::CollectHandledCount(const bool bReset) const
+{
+    int32 Total = 0;
+    for (UInputHandler_Benchmark* Handler : Handlers)
+    {
+        Total += Handler->GetHandledCount();
+        if (bReset)
+        {
+            Handler->ResetHandledCount();
+        }
+    }
+
+    return Total;
+}
@@ -0,0 +1,54 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NinjaInputHandler.h"
+#include "InputHandler_Benchmark.generated.h"
+
+/**
+ * Synthetic handler used by the benchmark commandlet.
+ *
+ * It performs no gameplay work, only counting how many times it was invoked, so the measured
+ * cost reflects the manager's dispatch and buffering overhead.
+ */
+UCLASS(NotBlueprintable, HideDropdown, Transient)
+class NINJAINPUTEDITOR_API UInputHandler_Benchmark : public UNinjaInputHandler
+{
+    
+    GENERATED_BODY()
+
+public:
+
+    UInputHandler_Benchmark();
+
+    /**
+     * Assigns the actions handled by this handler and its buffering behavior.
+     *
+     * @param Actions
+     *      Input Actions that will be handled for the "Triggered" event.
+     *
+     * @param bBuffered
+     *      Determines if this handler can be buffered.
+     */
+    void Configure(const TArray<UInputAction*>& Actions, bool bBuffered);
+
+    /** Changes the buffering behavior, without touching the assigned actions. */
+    void SetCanBeBuffered(bool bBuffered);
+
+    /** Provides how many times this handler was invoked. */
+    int32 GetHandledCount() const { return HandledCount; }
+
+    /** Resets the invocation counter. */
+    void ResetHandledCount() { HandledCount = 0; }
+
+protected:
+
+    virtual void HandleTriggeredEvent_Implementation(UNinjaInputManagerComponent* Manager,
+        const FInputActionValue& Value, const UInputAction* InputAction) const override;
+
+private:
+
+    /** Number of times this handler was invoked. */
+    mutable int32 HandledCount;
+    
+};
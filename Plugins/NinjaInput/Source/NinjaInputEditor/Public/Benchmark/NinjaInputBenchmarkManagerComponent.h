@@ -0,0 +1,39 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NinjaInputManagerComponent.h"
+#include "NinjaInputBenchmarkManagerComponent.generated.h"
+
+/**
+ * Input Manager used by the benchmark commandlet.
+ *
+ * Exposes the internal dispatch entry point, so events can be injected without going
+ * through the Enhanced Input pipeline, which is not ticking in a headless world.
+ */
+UCLASS(NotBlueprintable, HideDropdown, Transient)
+class NINJAINPUTEDITOR_API UNinjaInputBenchmarkManagerComponent : public UNinjaInputManagerComponent
+{
+    
+    GENERATED_BODY()
+
+public:
+
+    /**
+     * Dispatches an action instance, exactly as the Enhanced Input bindings would.
+     *
+     * @param ActionInstance
+     *      Details about the Action that must be processed.
+     *      
+     * @param TriggerEvent
+     *      The trigger being dispatched.
+     */
+    void BenchmarkDispatch(const FInputActionInstance& ActionInstance, const ETriggerEvent TriggerEvent)
+    {
+        Dispatch(ActionInstance, TriggerEvent);
+    }
+
+    /** Provides the number of commands currently waiting in the buffer. */
+    int32 GetBufferedCommandCount() const { return BufferedCommands.Num(); }
+    
+};
@@ -0,0 +1,101 @@
+﻿// Ninja Bear Studio Inc. 2023, all rights reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "NinjaInputBenchmarkCommandlet.generated.h"
+
+class APawn;
+class APlayerController;
+class FJsonObject;
+class UInputAction;
+class UInputHandler_Benchmark;
+class UNinjaInputBenchmarkManagerComponent;
+class UNinjaInputSetupDataAsset;
+class UWorld;
+
+/**
+ * Headless benchmark for the Input Manager's hot paths.
+ *
+ * Builds synthetic Setup Data Assets, attaches them to a locally controlled test pawn and
+ * measures dispatch throughput, allocations per event, input buffer cycles and setup
+ * addition/removal. Results are written as JSON, so they can be tracked over time.
+ *
+ * Allocations are read from the allocator's own counters, so they are only reported in
+ * builds with stats.
+ *
+ * Usage:
+ *      UnrealEditor-Cmd <Project>.uproject -run=NinjaInputBenchmark -nullrhi -unattended
+ *          [-Setups=4] [-Handlers=16] [-Actions=8] [-Events=100000] [-Iterations=100]
+ *          [-Output=<Path>.json]
+ */
+UCLASS()
+class NINJAINPUTEDITOR_API UNinjaInputBenchmarkCommandlet : public UCommandlet
+{
+    
+    GENERATED_BODY()
+
+public:
+
+    UNinjaInputBenchmarkCommandlet();
+
+    // -- Begin Commandlet implementation
+    virtual int32 Main(const FString& Params) override;
+    // -- End Commandlet implementation
+
+private:
+
+    /** Settings parsed from the command line. */
+    struct FBenchmarkSettings
+    {
+        int32 Setups = 4;
+        int32 HandlersPerSetup = 16;
+        int32 ActionsPerSetup = 8;
+        int32 Events = 100000;
+        int32 Iterations = 100;
+        FString OutputPath;
+    };
+
+    /** Objects created for the benchmark, kept referenced while it runs. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UObject>> BenchmarkObjects;
+
+    /** Synthetic setups created for the benchmark. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UNinjaInputSetupDataAsset>> Setups;
+
+    /** All actions created for the benchmark. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UInputAction>> Actions;
+
+    /** All handlers created for the benchmark. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UInputHandler_Benchmark>> Handlers;
+    
+    static FBenchmarkSettings ParseSettings(const FString& Params);
+
+    /** Creates a game world that can host the test pawn. */
+    static UWorld* CreateBenchmarkWorld();
+
+    /** Destroys the world created for the benchmark. */
+    static void DestroyBenchmarkWorld(UWorld* World);
+
+    /** Spawns a locally controlled pawn, with an Enhanced Input Component, and the benchmark manager. */
+    static UNinjaInputBenchmarkManagerComponent* SpawnBenchmarkPawn(UWorld* World);
+
+    /** Creates all synthetic Setup Data Assets, based on the current settings. */
+    void CreateSetups(const FBenchmarkSettings& Settings);
+
+    /** Measures how long it takes to add and remove all setups. */
+    TSharedRef<FJsonObject> MeasureSetupChanges(UNinjaInputBenchmarkManagerComponent* Manager, const FBenchmarkSettings& Settings) const;
+
+    /** Measures the dispatch throughput and allocations, with the buffer closed. */
+    TSharedRef<FJsonObject> MeasureDispatch(UNinjaInputBenchmarkManagerComponent* Manager, const FBenchmarkSettings& Settings) const;
+
+    /** Measures complete buffer cycles: open, buffered dispatch and release. */
+    TSharedRef<FJsonObject> MeasureBuffer(UNinjaInputBenchmarkManagerComponent* Manager, const FBenchmarkSettings& Settings) const;
+
+    /** Total number of handler invocations since the last reset. */
+    int32 CollectHandledCount(bool bReset) const;
+    
+};